@@ -27,9 +27,20 @@ void writeChunk(Chunk *chunk, uint8_t byte, int line)
   if (chunk->capacity < chunk->count + 1)
   {
     int oldCapacity = chunk->capacity;
-    chunk->capacity = GROW_CAPACITY(oldCapacity);
-    chunk->code = GROW_ARRAY(uint8_t, chunk->code, oldCapacity, chunk->capacity);
-    chunk->lines = GROW_ARRAY(int, chunk->lines, oldCapacity, chunk->capacity);
+    int capacity = GROW_CAPACITY(oldCapacity);
+    // out of memory: the byte is dropped and the runtime error fails the compile
+    uint8_t *code = GROW_ARRAY(uint8_t, chunk->code, oldCapacity, capacity);
+    if (code == NULL)
+      return;
+    int *lines = GROW_ARRAY(int, chunk->lines, oldCapacity, capacity);
+    if (lines == NULL)
+    {
+      chunk->code = GROW_ARRAY(uint8_t, code, capacity, oldCapacity);
+      return;
+    }
+    chunk->code = code;
+    chunk->lines = lines;
+    chunk->capacity = capacity;
   }
 
   chunk->code[chunk->count] = byte; // finally put in the value of opcode or any other data into our array "code"
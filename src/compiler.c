@@ -93,6 +93,7 @@ typedef struct LoopCompiler
 } LoopCompiler;
 
 static LoopCompiler *currentLoop = NULL;
+
 static void breakStatement(void);
 
 Parser parser;
@@ -118,13 +119,13 @@ void print_line(const char *s, int n)
       while (s[i] && s[i] != '\n')
         i++;
       int length = i - start;
-      char *line = (char *)malloc((size_t)length + 1);
+      char *line = (char *)rawReallocate(NULL, 0, (size_t)length + 1);
       if (line == NULL)
         return;
       memcpy(line, s + start, (size_t)length);
       line[length] = '\0';
       reportDiagnostic(PB_DIAGNOSTIC_COMPILE, line);
-      free(line);
+      rawReallocate(line, (size_t)length + 1, 0);
       return;
     }
     if (s[i++] == '\n')
@@ -135,14 +136,14 @@ void print_line(const char *s, int n)
 static void printErrorMarker(int column)
 {
   int spaces = column > 1 ? column - 2 : 0;
-  char *marker = (char *)malloc((size_t)spaces + 2);
+  char *marker = (char *)rawReallocate(NULL, 0, (size_t)spaces + 2);
   if (marker == NULL)
     return;
   memset(marker, ' ', (size_t)spaces);
   marker[spaces] = '^';
   marker[spaces + 1] = '\0';
   reportDiagnostic(PB_DIAGNOSTIC_COMPILE, marker);
-  free(marker);
+  rawReallocate(marker, (size_t)spaces + 2, 0);
 }
 
 static void errorAt(Token *token, const char *message)
@@ -188,7 +189,7 @@ static void errorAt(Token *token, const char *message)
 
   if (length >= 0)
   {
-    char *diagnostic = (char *)malloc((size_t)length + 1);
+    char *diagnostic = (char *)rawReallocate(NULL, 0, (size_t)length + 1);
     if (diagnostic != NULL)
     {
       if (sourceName != NULL && token->type == TOKEN_EOF)
@@ -214,7 +215,7 @@ static void errorAt(Token *token, const char *message)
         snprintf(diagnostic, (size_t)length + 1, "[line %d] Error: %s",
                  token->line, message);
       reportDiagnostic(PB_DIAGNOSTIC_COMPILE, diagnostic);
-      free(diagnostic);
+      rawReallocate(diagnostic, (size_t)length + 1, 0);
     }
   }
   parser.hadError = true;
@@ -418,6 +419,7 @@ static void declaration();
 static void classDeclaration();
 static ParseRule *getRule(TokenType type);
 static void parsePrecedence(Precedence precedence);
+static void infixOperators(Precedence precedence, bool canAssign);
 static ObjString *decodeStringToken(Token token);
 
 static uint8_t identifierConstant(Token *name)
@@ -764,10 +766,9 @@ static void funDeclaration()
   defineVariable(global);
 }
 
-static void varDeclaration()
+// the rest of a var declaration once its name has been declared
+static void varInitializer(uint8_t global)
 {
-  uint8_t global = parseVariable("Expect variable name.");
-
   if (match(TOKEN_EQUAL))
   {
     expression();
@@ -781,6 +782,11 @@ static void varDeclaration()
   defineVariable(global);
 }
 
+static void varDeclaration()
+{
+  varInitializer(parseVariable("Expect variable name."));
+}
+
 static void exportDeclaration()
 {
   bool validScope = current->type == TYPE_MODULE && current->scopeDepth == 0;
@@ -890,31 +896,9 @@ static void expressionStatement()
   emitByte(OP_POP);
 }
 
-static void forStatement()
+// the loop after a C-style initializer: condition, increment and body
+static void forClauses()
 {
-  LoopCompiler loopCompiler;
-  loopCompiler.enclosing = currentLoop;
-  loopCompiler.breakJumpOffsets = NULL;
-  loopCompiler.breakCount = 0;
-  loopCompiler.breakCapacity = 0;
-  loopCompiler.scopeDepth = current->scopeDepth;
-  currentLoop = &loopCompiler;
-
-  beginScope(); // wrap the whole statement in a block for proper scoping for variables
-  consume(TOKEN_LEFT_PAREN, "Expect '(' after 'for'.");
-  if (match(TOKEN_SEMICOLON))
-  {
-    // no initializer.
-  }
-  else if (match(TOKEN_VAR))
-  {
-    varDeclaration();
-  }
-  else
-  {
-    expressionStatement();
-  }
-
   int loopStart = currentChunk()->count;
   int exitJump = -1;
   if (!match(TOKEN_SEMICOLON))
@@ -948,6 +932,136 @@ static void forStatement()
     patchJump(exitJump);
     emitByte(OP_POP);
   }
+}
+
+// for (var x in collection) and for (var key, value in collection), with var
+// or let. The collection, a cursor and a guard live in hidden locals for the
+// whole loop; each pass pushes the next element as fresh locals of the body's
+// scope, so a closure made in the body keeps that pass's values.
+// 'in' only has a meaning between a for-in loop's variables and its
+// collection, so scripts can still use it as a name
+static bool checkIn(void)
+{
+  return check(TOKEN_IDENTIFIER) && parser.current.length == 2 &&
+         memcmp(parser.current.start, "in", 2) == 0;
+}
+
+// in range(...) becomes a counted loop when the call is the whole
+// collection; the prelude's range can be rebound, so OP_RANGE_INIT checks
+// what it calls when the loop starts. Any other collection is compiled as
+// usual and this returns false
+static bool rangeCollection(void)
+{
+  if (!check(TOKEN_IDENTIFIER) || parser.current.length != 5 ||
+      memcmp(parser.current.start, "range", 5) != 0)
+  {
+    expression();
+    return false;
+  }
+
+  advance();
+  namedVariable(parser.previous, true);
+  if (match(TOKEN_LEFT_PAREN))
+  {
+    uint8_t argCount = argumentList();
+    if (check(TOKEN_RIGHT_PAREN))
+    {
+      emitBytes(OP_RANGE_INIT, argCount);
+      return true;
+    }
+    emitBytes(OP_CALL, argCount);
+  }
+  infixOperators(PREC_ASSIGNMENT, true);
+  return false;
+}
+
+static void forInLoop(Token name)
+{
+  Token valueName = name;
+  uint8_t names = 1;
+  if (match(TOKEN_COMMA))
+  {
+    consume(TOKEN_IDENTIFIER, "Expect variable name after ','.");
+    valueName = parser.previous;
+    names = 2;
+    if (identifiersEqual(&name, &valueName))
+      error("Already a variable with this name in this scope.");
+  }
+  if (checkIn())
+    advance();
+  else
+    errorAtCurrent("Expect 'in' after loop variable.");
+
+  bool counted = false;
+  if (names == 1)
+    counted = rangeCollection();
+  else
+    expression();
+  consume(TOKEN_RIGHT_PAREN, "Expect ')' after loop collection.");
+  if (!counted)
+    emitByte(OP_ITER_INIT);
+
+  // the names start with a space, so no script can refer to them
+  addLocal(syntheticToken(" collection"));
+  markInitialized();
+  addLocal(syntheticToken(" cursor"));
+  markInitialized();
+  addLocal(syntheticToken(" guard"));
+  markInitialized();
+
+  int loopStart = currentChunk()->count;
+  emitBytes(counted ? OP_RANGE_NEXT : OP_ITER_NEXT, names);
+  emitBytes(0xff, 0xff);
+  int exitJump = currentChunk()->count - 2;
+
+  beginScope();
+  addLocal(name);
+  markInitialized();
+  if (names == 2)
+  {
+    addLocal(valueName);
+    markInitialized();
+  }
+  statement();
+  endScope();
+
+  emitLoop(loopStart);
+  patchJump(exitJump);
+}
+
+static void forStatement()
+{
+  LoopCompiler loopCompiler;
+  loopCompiler.enclosing = currentLoop;
+  loopCompiler.breakJumpOffsets = NULL;
+  loopCompiler.breakCount = 0;
+  loopCompiler.breakCapacity = 0;
+  loopCompiler.scopeDepth = current->scopeDepth;
+  currentLoop = &loopCompiler;
+
+  beginScope(); // wrap the whole statement in a block for proper scoping for variables
+  consume(TOKEN_LEFT_PAREN, "Expect '(' after 'for'.");
+  if (match(TOKEN_VAR) || match(TOKEN_LET))
+  {
+    consume(TOKEN_IDENTIFIER, "Expect variable name.");
+    if (checkIn() || check(TOKEN_COMMA))
+    {
+      forInLoop(parser.previous);
+    }
+    else
+    {
+      // inside the statement's scope the variable is always a local
+      declareVariable();
+      varInitializer(0);
+      forClauses();
+    }
+  }
+  else
+  {
+    if (!match(TOKEN_SEMICOLON))
+      expressionStatement(); // no initializer otherwise.
+    forClauses();
+  }
 
   endScope();
 
@@ -957,7 +1071,8 @@ static void forStatement()
     patchJump(currentLoop->breakJumpOffsets[i]);
   }
 
-  free(currentLoop->breakJumpOffsets);
+  rawReallocate(currentLoop->breakJumpOffsets,
+                sizeof(int) * (size_t)currentLoop->breakCapacity, 0);
   currentLoop = currentLoop->enclosing;
 }
 
@@ -1065,8 +1180,9 @@ static void breakStatement(void)
   {
     int oldCapacity = currentLoop->breakCapacity;
     int newCapacity = oldCapacity < 8 ? 8 : oldCapacity * 2;
-    int *offsets = (int *)realloc(currentLoop->breakJumpOffsets,
-                                 sizeof(int) * newCapacity);
+    int *offsets = (int *)rawReallocate(currentLoop->breakJumpOffsets,
+                                        sizeof(int) * (size_t)oldCapacity,
+                                        sizeof(int) * (size_t)newCapacity);
     if (offsets == NULL)
     {
       error("Not enough memory to compile loop breaks.");
@@ -1108,7 +1224,8 @@ static void whileStatement()
     patchJump(currentLoop->breakJumpOffsets[i]);
   }
 
-  free(currentLoop->breakJumpOffsets);
+  rawReallocate(currentLoop->breakJumpOffsets,
+                sizeof(int) * (size_t)currentLoop->breakCapacity, 0);
   currentLoop = currentLoop->enclosing;
 }
 
@@ -1209,38 +1326,192 @@ static void useStatement()
   emitByte(aliasConstant);
 }
 
+// Literals open with a three-byte placeholder that is patched once their
+// elements are known: OP_NEW_LIST or OP_NEW_HASHMAP with the element count,
+// so the container is allocated at its final size, or a template opcode when
+// the literal starts with constants. Those are collected at compile time
+// into a template object in the constant pool that the VM copies in one go.
+// Remaining elements are moved in from the stack in batches.
+static void patchLiteral(int instruction, OpCode templateOp,
+                         int templateConstant, int count)
+{
+  uint8_t *code = currentChunk()->code + instruction;
+  int operand = count > UINT16_MAX ? UINT16_MAX : count;
+  if (templateConstant != -1)
+  {
+    if (templateConstant > UINT16_MAX)
+      error("Too many constants in one chunk.");
+    code[0] = templateOp;
+    operand = templateConstant;
+  }
+  code[1] = (operand >> 8) & 0xff;
+  code[2] = operand & 0xff;
+}
+
+// whether the code from codeStart on is a lone scalar constant: a number or
+// string literal, possibly negated, or true, false or nil
+static bool scalarConstant(int codeStart, int codeEnd, int constantStart,
+                           int constantEnd, Value *value)
+{
+  Chunk *chunk = currentChunk();
+  uint8_t *code = chunk->code + codeStart;
+  int length = codeEnd - codeStart;
+
+  if (length == 1 && constantEnd == constantStart)
+  {
+    switch (code[0])
+    {
+    case OP_NIL:
+      *value = NIL_VAL;
+      return true;
+    case OP_TRUE:
+      *value = BOOL_VAL(true);
+      return true;
+    case OP_FALSE:
+      *value = BOOL_VAL(false);
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  if ((length != 2 && length != 3) || code[0] != OP_CONSTANT ||
+      code[1] != constantStart || constantEnd != constantStart + 1)
+    return false;
+
+  *value = chunk->constants.values[constantStart];
+  if (length == 3)
+  {
+    if (code[2] != OP_NEGATE || !IS_NUMBER(*value))
+      return false;
+    *value = NUMBER_VAL(-AS_NUMBER(*value));
+  }
+  return true;
+}
+
+// the element's value now lives in the template, so its code and constant
+// are dropped again
+static void dropElement(int codeStart, int constantStart)
+{
+  currentChunk()->count = codeStart;
+  currentChunk()->constants.count = constantStart;
+}
+
 static void list(bool canAssign) {
   (void)canAssign;
 
   emitByte(OP_NEW_LIST);
+  emitBytes(0xff, 0xff);
+  int instruction = currentChunk()->count - 3;
+  ObjList *template = NULL;
+  int templateConstant = -1;
+  bool constantPrefix = true;
+  int count = 0;
+  int pending = 0;
 
   if (!check(TOKEN_RIGHT_BRACKET)) {
     do {
+      int codeStart = currentChunk()->count;
+      int constantStart = currentChunk()->constants.count;
       expression();
-      emitByte(OP_LIST_LITERAL_APPEND);
+      count++;
+
+      Value value;
+      if (constantPrefix &&
+          scalarConstant(codeStart, currentChunk()->count, constantStart,
+                         currentChunk()->constants.count, &value)) {
+        dropElement(codeStart, constantStart);
+        push(value);
+        if (template == NULL) {
+          template = newList();
+          templateConstant = addConstant(currentChunk(), OBJ_VAL(template));
+        }
+        listAppend(template, value);
+        pop();
+        continue;
+      }
+
+      constantPrefix = false;
+      if (++pending == UINT8_MAX) {
+        emitBytes(OP_BUILD_LIST, (uint8_t)pending);
+        pending = 0;
+      }
     } while (match(TOKEN_COMMA));
   }
+  if (pending > 0)
+    emitBytes(OP_BUILD_LIST, (uint8_t)pending);
 
   consume(TOKEN_RIGHT_BRACKET, "Expect ']' after list elements.");
+  if (template != NULL) {
+    // stored at the literal's full size, so the copy never grows
+    listShrinkToFit(template);
+    listReserve(template, count);
+  }
+  patchLiteral(instruction, OP_LIST_TEMPLATE, templateConstant, count);
 }
 
 static void hashmap(bool canAssign)
 {
   (void)canAssign;
   emitByte(OP_NEW_HASHMAP);
+  emitBytes(0xff, 0xff);
+  int instruction = currentChunk()->count - 3;
+  ObjHashmap *template = NULL;
+  int templateConstant = -1;
+  bool constantPrefix = true;
+  int count = 0;
+  int pending = 0;
 
   if (!check(TOKEN_RIGHT_BRACE))
   {
     do
     {
+      int keyStart = currentChunk()->count;
+      int keyConstant = currentChunk()->constants.count;
       expression();
       consume(TOKEN_COLON, "Expect ':' between key and value.");
+      int valueStart = currentChunk()->count;
+      int valueConstant = currentChunk()->constants.count;
       expression();
-      emitByte(OP_HASHMAP_LITERAL_INSERT);
+      count++;
+
+      Value key;
+      Value value;
+      if (constantPrefix &&
+          scalarConstant(keyStart, valueStart, keyConstant, valueConstant, &key) &&
+          scalarConstant(valueStart, currentChunk()->count, valueConstant,
+                         currentChunk()->constants.count, &value) &&
+          mapKeyIsValid(key))
+      {
+        dropElement(keyStart, keyConstant);
+        push(key);
+        push(value);
+        if (template == NULL)
+        {
+          template = newHashmap();
+          templateConstant = addConstant(currentChunk(), OBJ_VAL(template));
+        }
+        mapSet(&template->items, key, value, NULL);
+        pop();
+        pop();
+        continue;
+      }
+
+      constantPrefix = false;
+      if (++pending == UINT8_MAX / 2)
+      {
+        emitBytes(OP_BUILD_MAP, (uint8_t)pending);
+        pending = 0;
+      }
     } while (match(TOKEN_COMMA));
   }
+  if (pending > 0)
+    emitBytes(OP_BUILD_MAP, (uint8_t)pending);
 
   consume(TOKEN_RIGHT_BRACE, "Expect '}' after hashmap elements.");
+  if (template != NULL)
+    mapReserve(&template->items, count);
+  patchLiteral(instruction, OP_MAP_TEMPLATE, templateConstant, count);
 }
 
 static void containerIndex(bool canAssign) {
@@ -1382,6 +1653,8 @@ static ObjString *decodeStringToken(Token token)
 {
   int rawLength = token.length - 2;
   char *chars = ALLOCATE(char, rawLength + 1);
+  if (chars == NULL)
+    return NULL;
   int length = 0;
 
   for (int i = 0; i < rawLength; i++)
@@ -1408,6 +1681,18 @@ static ObjString *decodeStringToken(Token token)
     }
   }
 
+  // escapes shrink the text; keep the buffer size in step with the length
+  // takeString and the sweep will free it with
+  if (length < rawLength)
+  {
+    char *shrunk = GROW_ARRAY(char, chars, rawLength + 1, length + 1);
+    if (shrunk == NULL)
+    {
+      FREE_ARRAY(char, chars, rawLength + 1);
+      return NULL;
+    }
+    chars = shrunk;
+  }
   chars[length] = '\0';
   return takeString(chars, length);
 }
@@ -1596,7 +1881,12 @@ static void parsePrecedence(Precedence precedence)
 
   bool canAssign = precedence <= PREC_ASSIGNMENT; // only consume the '=' if it is in context of a low-precedence expression
   prefixRule(canAssign);
+  infixOperators(precedence, canAssign);
+}
 
+// the rest of an expression whose prefix has already been compiled
+static void infixOperators(Precedence precedence, bool canAssign)
+{
   while (precedence <= getRule(parser.current.type)->precedence)
   {
     advance();
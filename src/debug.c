@@ -66,6 +66,15 @@ static int byteInstruction(const char *name, Chunk *chunk,
   return offset + 2; 
 }
 
+static int shortInstruction(const char *name, Chunk *chunk,
+                            int offset)
+{
+  uint16_t operand = (uint16_t)(chunk->code[offset + 1] << 8);
+  operand |= chunk->code[offset + 2];
+  printf("%-16s %4d\n", name, operand);
+  return offset + 3;
+}
+
 static int jumpInstruction(const char *name, int sign,
                            Chunk *chunk, int offset)
 {
@@ -76,6 +85,16 @@ static int jumpInstruction(const char *name, int sign,
   return offset + 3;
 }
 
+static int iterNextInstruction(const char *name, Chunk *chunk, int offset)
+{
+  uint8_t names = chunk->code[offset + 1];
+  uint16_t jump = (uint16_t)(chunk->code[offset + 2] << 8);
+  jump |= chunk->code[offset + 3];
+  printf("%-16s (%d names) %4d -> %d\n", name, names, offset,
+         offset + 4 + jump);
+  return offset + 4;
+}
+
 static int closureInstruction(Chunk *chunk, int offset)
 {
   offset++;
@@ -175,6 +194,14 @@ int disassembleInstruction(Chunk *chunk, int offset)
     return jumpInstruction("OP_JUMP_IF_FALSE", 1, chunk, offset);
   case OP_LOOP:
     return jumpInstruction("OP_LOOP", -1, chunk, offset);
+  case OP_ITER_INIT:
+    return simpleInstruction("OP_ITER_INIT", offset);
+  case OP_ITER_NEXT:
+    return iterNextInstruction("OP_ITER_NEXT", chunk, offset);
+  case OP_RANGE_INIT:
+    return byteInstruction("OP_RANGE_INIT", chunk, offset);
+  case OP_RANGE_NEXT:
+    return iterNextInstruction("OP_RANGE_NEXT", chunk, offset);
   case OP_CALL:
     return byteInstruction("OP_CALL", chunk, offset);
   case OP_GET_INDEX:
@@ -182,13 +209,17 @@ int disassembleInstruction(Chunk *chunk, int offset)
   case OP_SET_INDEX:
     return simpleInstruction("OP_SET_INDEX", offset);
   case OP_NEW_LIST:
-    return simpleInstruction("OP_NEW_LIST", offset);
-  case OP_LIST_LITERAL_APPEND:
-    return simpleInstruction("OP_LIST_LITERAL_APPEND", offset);
+    return shortInstruction("OP_NEW_LIST", chunk, offset);
+  case OP_LIST_TEMPLATE:
+    return shortInstruction("OP_LIST_TEMPLATE", chunk, offset);
+  case OP_BUILD_LIST:
+    return byteInstruction("OP_BUILD_LIST", chunk, offset);
   case OP_NEW_HASHMAP:
-    return simpleInstruction("OP_NEW_HASHMAP", offset);
-  case OP_HASHMAP_LITERAL_INSERT:
-    return simpleInstruction("OP_HASHMAP_LITERAL_INSERT", offset);
+    return shortInstruction("OP_NEW_HASHMAP", chunk, offset);
+  case OP_MAP_TEMPLATE:
+    return shortInstruction("OP_MAP_TEMPLATE", chunk, offset);
+  case OP_BUILD_MAP:
+    return byteInstruction("OP_BUILD_MAP", chunk, offset);
   case OP_CLOSURE:
     return closureInstruction(chunk, offset);
   case OP_CLOSE_UPVALUE:
@@ -0,0 +1,145 @@
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLOAT_ARRAY_USE_SSE2
+#endif
+
+#include "headers/float_array.h"
+
+// the scalar forms of minpd and maxpd: when either side is NaN the second
+// operand wins, exactly as in the SSE2 instructions
+static inline double minOf(double left, double right) {
+  return left < right ? left : right;
+}
+
+static inline double maxOf(double left, double right) {
+  return left > right ? left : right;
+}
+
+void floatArrayFill(double* values, int count, double value) {
+  int i = 0;
+#ifdef FLOAT_ARRAY_USE_SSE2
+  __m128d lanes = _mm_set1_pd(value);
+  for (; i + 2 <= count; i += 2) _mm_storeu_pd(values + i, lanes);
+#endif
+  for (; i < count; i++) values[i] = value;
+}
+
+void floatArrayScale(double* values, int count, double factor) {
+  int i = 0;
+#ifdef FLOAT_ARRAY_USE_SSE2
+  __m128d lanes = _mm_set1_pd(factor);
+  for (; i + 2 <= count; i += 2) {
+    _mm_storeu_pd(values + i, _mm_mul_pd(_mm_loadu_pd(values + i), lanes));
+  }
+#endif
+  for (; i < count; i++) values[i] *= factor;
+}
+
+void floatArrayAddScalar(double* values, int count, double amount) {
+  int i = 0;
+#ifdef FLOAT_ARRAY_USE_SSE2
+  __m128d lanes = _mm_set1_pd(amount);
+  for (; i + 2 <= count; i += 2) {
+    _mm_storeu_pd(values + i, _mm_add_pd(_mm_loadu_pd(values + i), lanes));
+  }
+#endif
+  for (; i < count; i++) values[i] += amount;
+}
+
+void floatArrayAdd(double* values, const double* other, int count) {
+  int i = 0;
+#ifdef FLOAT_ARRAY_USE_SSE2
+  for (; i + 2 <= count; i += 2) {
+    _mm_storeu_pd(values + i, _mm_add_pd(_mm_loadu_pd(values + i),
+                                         _mm_loadu_pd(other + i)));
+  }
+#endif
+  for (; i < count; i++) values[i] += other[i];
+}
+
+// Reductions keep four lanes, element i going to lane i % 4, fold them as
+// (lane0 . lane2) . (lane1 . lane3) and then take the tail in order.
+
+double floatArraySum(const double* values, int count) {
+  int i = 0;
+  double result = -0.0; // the identity for addition, keeping the sum of -0 as -0
+  if (count >= 4) {
+#ifdef FLOAT_ARRAY_USE_SSE2
+    __m128d low = _mm_set1_pd(-0.0);
+    __m128d high = low;
+    for (; i + 4 <= count; i += 4) {
+      low = _mm_add_pd(low, _mm_loadu_pd(values + i));
+      high = _mm_add_pd(high, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(low, high));
+    result = lanes[0] + lanes[1];
+#else
+    double lanes[4] = {-0.0, -0.0, -0.0, -0.0};
+    for (; i + 4 <= count; i += 4) {
+      for (int lane = 0; lane < 4; lane++) lanes[lane] += values[i + lane];
+    }
+    result = (lanes[0] + lanes[2]) + (lanes[1] + lanes[3]);
+#endif
+  }
+  for (; i < count; i++) result += values[i];
+  return result;
+}
+
+// count must be at least one
+double floatArrayMin(const double* values, int count) {
+  int i = 1;
+  double result = values[0];
+  if (count >= 4) {
+#ifdef FLOAT_ARRAY_USE_SSE2
+    __m128d low = _mm_loadu_pd(values);
+    __m128d high = _mm_loadu_pd(values + 2);
+    for (i = 4; i + 4 <= count; i += 4) {
+      low = _mm_min_pd(low, _mm_loadu_pd(values + i));
+      high = _mm_min_pd(high, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_min_pd(low, high));
+    result = minOf(lanes[0], lanes[1]);
+#else
+    double lanes[4] = {values[0], values[1], values[2], values[3]};
+    for (i = 4; i + 4 <= count; i += 4) {
+      for (int lane = 0; lane < 4; lane++) {
+        lanes[lane] = minOf(lanes[lane], values[i + lane]);
+      }
+    }
+    result = minOf(minOf(lanes[0], lanes[2]), minOf(lanes[1], lanes[3]));
+#endif
+  }
+  for (; i < count; i++) result = minOf(result, values[i]);
+  return result;
+}
+
+// count must be at least one
+double floatArrayMax(const double* values, int count) {
+  int i = 1;
+  double result = values[0];
+  if (count >= 4) {
+#ifdef FLOAT_ARRAY_USE_SSE2
+    __m128d low = _mm_loadu_pd(values);
+    __m128d high = _mm_loadu_pd(values + 2);
+    for (i = 4; i + 4 <= count; i += 4) {
+      low = _mm_max_pd(low, _mm_loadu_pd(values + i));
+      high = _mm_max_pd(high, _mm_loadu_pd(values + i + 2));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_max_pd(low, high));
+    result = maxOf(lanes[0], lanes[1]);
+#else
+    double lanes[4] = {values[0], values[1], values[2], values[3]};
+    for (i = 4; i + 4 <= count; i += 4) {
+      for (int lane = 0; lane < 4; lane++) {
+        lanes[lane] = maxOf(lanes[lane], values[i + lane]);
+      }
+    }
+    result = maxOf(maxOf(lanes[0], lanes[2]), maxOf(lanes[1], lanes[3]));
+#endif
+  }
+  for (; i < count; i++) result = maxOf(result, values[i]);
+  return result;
+}
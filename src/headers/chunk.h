@@ -40,13 +40,19 @@ typedef enum {
   OP_JUMP,
   OP_JUMP_IF_FALSE,
   OP_LOOP,
+  OP_ITER_INIT,
+  OP_ITER_NEXT,
+  OP_RANGE_INIT,
+  OP_RANGE_NEXT,
   OP_CALL,
   OP_GET_INDEX,
   OP_SET_INDEX,
   OP_NEW_LIST,
-  OP_LIST_LITERAL_APPEND,
+  OP_LIST_TEMPLATE,
+  OP_BUILD_LIST,
   OP_NEW_HASHMAP,
-  OP_HASHMAP_LITERAL_INSERT,
+  OP_MAP_TEMPLATE,
+  OP_BUILD_MAP,
   OP_CLOSURE,
   OP_CLOSE_UPVALUE,
   OP_RETURN,
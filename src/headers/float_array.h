@@ -0,0 +1,17 @@
+#ifndef PB_FLOAT_ARRAY_H
+#define PB_FLOAT_ARRAY_H
+
+#include "common.h"
+
+// Bulk kernels over a run of raw doubles, two lanes at a time where SSE2 is
+// available. Sums, minimums and maximums combine their lanes in a fixed
+// order, so the scalar fallback gives bit-identical results.
+void floatArrayFill(double* values, int count, double value);
+void floatArrayScale(double* values, int count, double factor);
+void floatArrayAddScalar(double* values, int count, double amount);
+void floatArrayAdd(double* values, const double* other, int count);
+double floatArraySum(const double* values, int count);
+double floatArrayMin(const double* values, int count);
+double floatArrayMax(const double* values, int count);
+
+#endif
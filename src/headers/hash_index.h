@@ -0,0 +1,87 @@
+#ifndef PB_HASH_INDEX_H
+#define PB_HASH_INDEX_H
+
+#include <string.h>
+
+#include "value.h"
+
+// The open-addressing index shared by Map and Set. Each slot holds the
+// position of an entry in the container's dense entry array, or one of the
+// markers below, in one, two or four bytes depending on the index size.
+#define HASH_INDEX_EMPTY (-1)
+#define HASH_INDEX_DELETED (-2)
+
+#define HASH_INDEX_MIN 8
+
+static inline size_t hashIndexWidth(int capacity) {
+  if (capacity <= 0x80) return sizeof(int8_t);
+  if (capacity <= 0x8000) return sizeof(int16_t);
+  return sizeof(int32_t);
+}
+
+static inline size_t hashIndexBytes(int capacity) {
+  return (size_t)capacity * hashIndexWidth(capacity);
+}
+
+static inline void hashIndexClear(void* index, int capacity) {
+  memset(index, 0xff, hashIndexBytes(capacity));
+}
+
+static inline int hashIndexGet(void* index, int capacity, int slot) {
+  switch (hashIndexWidth(capacity)) {
+    case sizeof(int8_t):
+      return ((int8_t*)index)[slot];
+    case sizeof(int16_t):
+      return ((int16_t*)index)[slot];
+    default:
+      return ((int32_t*)index)[slot];
+  }
+}
+
+static inline void hashIndexSet(void* index, int capacity, int slot, int entry) {
+  switch (hashIndexWidth(capacity)) {
+    case sizeof(int8_t):
+      ((int8_t*)index)[slot] = (int8_t)entry;
+      break;
+    case sizeof(int16_t):
+      ((int16_t*)index)[slot] = (int16_t)entry;
+      break;
+    default:
+      ((int32_t*)index)[slot] = (int32_t)entry;
+      break;
+  }
+}
+
+// probes start at the low bits of the hash and fold the high bits in as
+// they go, which visits every slot once the perturbation has shifted out
+#define HASH_INDEX_NEXT(slot, perturb, mask) \
+  ((perturb) >>= 5, (slot) = ((slot) * 5 + (perturb) + 1) & (mask))
+
+static inline int hashIndexFindEmpty(void* index, int capacity, uint32_t hash) {
+  uint32_t mask = (uint32_t)capacity - 1;
+  uint32_t perturb = hash;
+  uint32_t slot = hash & mask;
+  while (hashIndexGet(index, capacity, (int)slot) != HASH_INDEX_EMPTY) {
+    HASH_INDEX_NEXT(slot, perturb, mask);
+  }
+  return (int)slot;
+}
+
+// keys are never lists or maps, and strings are interned, so equal keys are
+// the same bits once their types agree
+static inline bool hashKeysMatch(Value entryKey, Value key) {
+  if (entryKey.type != key.type) return false;
+  switch (key.type) {
+    case VAL_NUMBER:
+      return AS_NUMBER(entryKey) == AS_NUMBER(key);
+    case VAL_OBJ:
+      return AS_OBJ(entryKey) == AS_OBJ(key);
+    case VAL_BOOL:
+      return AS_BOOL(entryKey) == AS_BOOL(key);
+    case VAL_NIL:
+      return true;
+  }
+  return false;
+}
+
+#endif
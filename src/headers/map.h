@@ -3,36 +3,41 @@
 
 #include "value.h"
 
+// Entries are kept dense and in insertion order; a separate open-addressing
+// index of small integers points into them, so iteration is a linear scan
+// and the index costs one to four bytes per slot. Deleted entries stay as
+// holes until the next rebuild compacts them away.
 typedef struct {
   Value key;
   Value value;
   uint32_t hash;
-  int nextBucket;
-  int previousOrder;
-  int nextOrder;
   bool occupied;
 } MapEntry;
 
 typedef struct {
-  int count;
-  int capacity;
-  int used;
-  int bucketCapacity;
-  int firstOrder;
-  int lastOrder;
-  int freeList;
-  MapEntry* entries;
-  int* buckets;
+  int count;         // live entries
+  int used;          // entries appended since the last rebuild, holes included
+  bool dense;        // the keys are exactly 0, 1, ... used - 1, in order
+  int capacity;      // entries that fit before a rebuild
+  int indexCapacity; // index slots, a power of two, 0 before the first insert
+  MapEntry* entries; // start of the single allocation; the index follows
+  void* index;       // int8_t, int16_t or int32_t slots, by indexCapacity
+  uint32_t modifications; // bumped by every insert, delete and rebuild
 } Map;
 
 void initMap(Map* map);
 void freeMap(Map* map);
 void markMap(Map* map);
+size_t mapBytes(Map* map);
 bool mapKeyIsValid(Value key);
+uint32_t mapKeyHash(Value key);
 bool mapGet(Map* map, Value key, Value* value);
 bool mapSet(Map* map, Value key, Value value, bool* isNewKey);
 bool mapDelete(Map* map, Value key);
 void mapClear(Map* map);
+void mapCopy(Map* from, Map* to);
+void mapReserve(Map* map, int count);
+void mapShrinkToFit(Map* map);
 int mapCount(Map* map);
 int mapFirstEntry(Map* map);
 int mapNextEntry(Map* map, int entryIndex);
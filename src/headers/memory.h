@@ -21,10 +21,41 @@
 #define FREE_ARRAY(type, pointer, oldCount) \
 reallocate(pointer, sizeof(type) * (oldCount), 0)
 
+// objects are carved out of pages holding slots of one size; sizes step by
+// 8 bytes up to OBJ_SIZE_CLASSES * 8 and anything bigger gets a page sized
+// to hold just that one object
+#define OBJ_PAGE_SIZE 4096
+#define OBJ_SIZE_CLASSES 32
+#define OBJ_FREE 0xff
+
+typedef struct ObjPage {
+  struct ObjPage* next;
+  uint32_t slotSize;
+  uint32_t slotCount;
+} ObjPage;
+
+typedef struct FreeSlot {
+  Obj obj;
+  struct FreeSlot* next;
+} FreeSlot;
+
+#define PAGE_SLOT(page, index) \
+  ((Obj*)((char*)((page) + 1) + (size_t)(index) * (page)->slotSize))
+
 void* reallocate(void* pointer, size_t oldSize, size_t newSize);
+void* rawReallocate(void* pointer, size_t oldSize, size_t newSize);
+bool reserveSparePage(void);
+Obj* allocateObjectSlot(size_t size);
+bool heapContainsObject(const void* pointer);
+typedef void (*ObjectVisitor)(Obj* object, void* context);
+
+void visitRoots(ObjectVisitor visitor, void* context);
+void visitReferences(Obj* object, ObjectVisitor visitor, void* context);
+size_t objectOwnedBytes(Obj* object);
 void markObject(Obj* object);
 void markValue(Value value);
 void collectGarbage();
+size_t initialGCThreshold(void);
 void freeObjects();
 
 #endif // !clox_memory_h
\ No newline at end of file
@@ -20,10 +20,64 @@ Value listCopyNative(int argCount, Value *args);
 Value listIndexNative(int argCount, Value *args);
 Value listCountNative(int argCount, Value *args);
 Value listReverseNative(int argCount, Value *args);
+Value listReserveNative(int argCount, Value *args);
+Value listShrinkToFitNative(int argCount, Value *args);
+Value listMapNative(int argCount, Value *args);
+Value listFilterNative(int argCount, Value *args);
+Value listReduceNative(int argCount, Value *args);
+Value listForEachNative(int argCount, Value *args);
+Value listAnyNative(int argCount, Value *args);
+Value listAllNative(int argCount, Value *args);
 Value mapHasNative(int argCount, Value *args);
 Value mapGetNative(int argCount, Value *args);
 Value mapDeleteNative(int argCount, Value *args);
 Value mapClearNative(int argCount, Value *args);
+Value mapReserveNative(int argCount, Value *args);
+Value mapShrinkToFitNative(int argCount, Value *args);
+Value setNative(int argCount, Value *args);
+Value setAddNative(int argCount, Value *args);
+Value setHasNative(int argCount, Value *args);
+Value setDeleteNative(int argCount, Value *args);
+Value setClearNative(int argCount, Value *args);
+Value setUnionNative(int argCount, Value *args);
+Value setIntersectionNative(int argCount, Value *args);
+Value setDifferenceNative(int argCount, Value *args);
+Value setValuesNative(int argCount, Value *args);
+Value priorityQueueNative(int argCount, Value *args);
+Value priorityQueuePushNative(int argCount, Value *args);
+Value priorityQueuePopNative(int argCount, Value *args);
+Value priorityQueuePeekNative(int argCount, Value *args);
+Value floatArrayNative(int argCount, Value *args);
+Value floatArrayFillNative(int argCount, Value *args);
+Value floatArrayScaleNative(int argCount, Value *args);
+Value floatArrayAddNative(int argCount, Value *args);
+Value floatArraySumNative(int argCount, Value *args);
+Value floatArrayMinNative(int argCount, Value *args);
+Value floatArrayMaxNative(int argCount, Value *args);
+Value floatArrayToListNative(int argCount, Value *args);
+Value rangeNative(int argCount, Value *args);
+Value sequenceMapNative(int argCount, Value *args);
+Value sequenceFilterNative(int argCount, Value *args);
+Value sequenceReduceNative(int argCount, Value *args);
+Value sequenceToListNative(int argCount, Value *args);
+Value stringBuilderNative(int argCount, Value *args);
+Value stringBuilderAppendNative(int argCount, Value *args);
+Value stringBuilderAppendLineNative(int argCount, Value *args);
+Value stringBuilderLenNative(int argCount, Value *args);
+Value stringBuilderClearNative(int argCount, Value *args);
+Value stringBuilderBuildNative(int argCount, Value *args);
+Value stringFindNative(int argCount, Value *args);
+Value stringSplitNative(int argCount, Value *args);
+Value stringJoinNative(int argCount, Value *args);
+Value stringReplaceNative(int argCount, Value *args);
+Value stringStartsWithNative(int argCount, Value *args);
+Value stringEndsWithNative(int argCount, Value *args);
+Value stringTrimNative(int argCount, Value *args);
+Value stringUpperNative(int argCount, Value *args);
+Value stringLowerNative(int argCount, Value *args);
+Value stringBytesNative(int argCount, Value *args);
+Value chrNative(int argCount, Value *args);
+Value ordNative(int argCount, Value *args);
 Value lenNative(int argCount, Value *args);
 Value typeNative(int argCount, Value *args);
 Value strNative(int argCount, Value *args);
@@ -32,7 +86,4 @@ Value getTime(int argCount, Value* args);
 void defineNative(const char *name, NativeFn function);
 void defineHostNative(const char *name, PbNativeFn function, void *userData);
 
-// comparison functions for sorting
-int Valuecomp(const void *elem1, const void *elem2);
-
 #endif
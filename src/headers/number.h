@@ -0,0 +1,14 @@
+#ifndef PB_NUMBER_H
+#define PB_NUMBER_H
+
+// room for the longest text formatNumber writes, with its terminator
+#define NUMBER_BUFFER_SIZE 32
+
+// Writes the shortest decimal text that reads back as exactly number, and
+// returns its length. Whole numbers below 10^21 are written out in full,
+// other numbers use an exponent below 10^-6 and from 10^21 up, as in
+// 1.5e-7 and 1e+21. Infinities are inf and -inf, NaN is nan. The output
+// never depends on the C locale.
+int formatNumber(double number, char* buffer);
+
+#endif
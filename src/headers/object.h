@@ -1,58 +1,83 @@
-#ifndef clox_object_h
-#define clox_object_h
-
-#include "common.h"
+#ifndef clox_object_h
+#define clox_object_h
+
+#include "common.h"
 #include "chunk.h"
 #include "value.h"
 #include "table.h"
 #include "map.h"
+#include "set.h"
+#include "priority_queue.h"
 #include "pb.h"
-
-#define OBJ_TYPE(value)      (AS_OBJ(value)->type)
-
+
+#define OBJ_TYPE(value)      (AS_OBJ(value)->type)
+
 #define IS_FUNCTION(value)    isObjType(value, OBJ_FUNCTION)
 #define IS_CLOSURE(value)     isObjType(value, OBJ_CLOSURE)
-#define IS_NATIVE(value)      isObjType(value, OBJ_NATIVE)
-#define IS_STRING(value)      isObjType(value, OBJ_STRING)
-#define IS_LIST(value)        isObjType(value, OBJ_LIST)
-#define IS_HASHMAP(value)     isObjType(value, OBJ_HASHMAP)
-#define IS_CLASS(value)       isObjType(value, OBJ_CLASS)
+#define IS_NATIVE(value)      isObjType(value, OBJ_NATIVE)
+#define IS_STRING(value)      isObjType(value, OBJ_STRING)
+#define IS_LIST(value)        isObjType(value, OBJ_LIST)
+#define IS_HASHMAP(value)     isObjType(value, OBJ_HASHMAP)
+#define IS_CLASS(value)       isObjType(value, OBJ_CLASS)
 #define IS_INSTANCE(value)    isObjType(value, OBJ_INSTANCE)
 #define IS_BOUND_METHOD(value) isObjType(value, OBJ_BOUND_METHOD)
 #define IS_MODULE(value)      isObjType(value, OBJ_MODULE)
-
+#define IS_SET(value)         isObjType(value, OBJ_SET)
+#define IS_PRIORITY_QUEUE(value) isObjType(value, OBJ_PRIORITY_QUEUE)
+#define IS_FLOAT_ARRAY(value) isObjType(value, OBJ_FLOAT_ARRAY)
+#define IS_RANGE(value)       isObjType(value, OBJ_RANGE)
+#define IS_SEQUENCE(value)    isObjType(value, OBJ_SEQUENCE)
+#define IS_STRING_BUILDER(value) isObjType(value, OBJ_STRING_BUILDER)
+#define IS_BYTES(value)       isObjType(value, OBJ_BYTES)
+
 #define AS_FUNCTION(value)     ((ObjFunction*)AS_OBJ(value))
 #define AS_CLOSURE(value)      ((ObjClosure*)AS_OBJ(value))
 #define AS_NATIVE(value)      ((ObjNative*)AS_OBJ(value))
-#define AS_STRING(value)      ((ObjString*)AS_OBJ(value))
-#define AS_CSTRING(value)     (((ObjString*)AS_OBJ(value))->chars)
-#define AS_LIST(value)        ((ObjList*)AS_OBJ(value))
-#define AS_HASHMAP(value)     ((ObjHashmap*)AS_OBJ(value))
-#define AS_CLASS(value)       ((ObjClass*)AS_OBJ(value))
+#define AS_STRING(value)      ((ObjString*)AS_OBJ(value))
+#define AS_CSTRING(value)     (((ObjString*)AS_OBJ(value))->chars)
+#define AS_LIST(value)        ((ObjList*)AS_OBJ(value))
+#define AS_HASHMAP(value)     ((ObjHashmap*)AS_OBJ(value))
+#define AS_CLASS(value)       ((ObjClass*)AS_OBJ(value))
 #define AS_INSTANCE(value)    ((ObjInstance*)AS_OBJ(value))
 #define AS_BOUND_METHOD(value) ((ObjBoundMethod*)AS_OBJ(value))
 #define AS_MODULE(value)      ((ObjModule*)AS_OBJ(value))
-
+#define AS_SET(value)         ((ObjSet*)AS_OBJ(value))
+#define AS_PRIORITY_QUEUE(value) ((ObjPriorityQueue*)AS_OBJ(value))
+#define AS_FLOAT_ARRAY(value) ((ObjFloatArray*)AS_OBJ(value))
+#define AS_RANGE(value)       ((ObjRange*)AS_OBJ(value))
+#define AS_SEQUENCE(value)    ((ObjSequence*)AS_OBJ(value))
+#define AS_STRING_BUILDER(value) ((ObjStringBuilder*)AS_OBJ(value))
+#define AS_BYTES(value)       ((ObjBytes*)AS_OBJ(value))
+
+// keep in step with PbObjectType in pb.h, the GC stats are indexed by this
 typedef enum {
   OBJ_FUNCTION,
   OBJ_CLOSURE,
   OBJ_UPVALUE,
-  OBJ_NATIVE,
-  OBJ_STRING,
-  OBJ_LIST,
-  OBJ_HASHMAP,
-  OBJ_CLASS,
+  OBJ_NATIVE,
+  OBJ_STRING,
+  OBJ_LIST,
+  OBJ_HASHMAP,
+  OBJ_CLASS,
   OBJ_INSTANCE,
   OBJ_BOUND_METHOD,
   OBJ_MODULE,
+  OBJ_SET,
+  OBJ_PRIORITY_QUEUE,
+  OBJ_FLOAT_ARRAY,
+  OBJ_RANGE,
+  OBJ_SEQUENCE,
+  OBJ_STRING_BUILDER,
+  OBJ_BYTES,
 } ObjType;
-
-struct Obj {
-  ObjType type;
-  bool isMarked;
-  struct Obj* next;
-};
-
+
+// objects live in size-class pages (see memory.h) rather than on a linked
+// list, so the header is just the type tag and the mark bit
+struct Obj {
+  uint8_t type;
+  bool isMarked;
+};
+
 typedef struct ObjFunction {
   Obj obj;
   int arity;
@@ -78,7 +103,7 @@ typedef struct {
   int upvalueCount;
   ObjModule* module;
 } ObjClosure;
-
+
 typedef Value (*NativeFn)(int argCount, Value* args);
 
 typedef struct {
@@ -87,38 +112,97 @@ typedef struct {
   PbNativeFn hostFunction;
   void* userData;
 } ObjNative;
-
-// string payload
-struct ObjString {
-  Obj obj;
-  int length;
-  char* chars;
-  uint32_t hash; //each string stores its own hash so we dont have to calculate it everytime we have to look something up in the hashmap
-};
-
-typedef struct {
-  Obj obj;
-  // int length;
-  ValueArray items;
-} ObjList;
-
+
+// string payload
+struct ObjString {
+  Obj obj;
+  int length;
+  char* chars;
+  uint32_t hash; //each string stores its own hash so we dont have to calculate it everytime we have to look something up in the hashmap
+};
+
+// items.values points past `front` slots released by removals near the
+// start, so taking from either end is O(1); the allocation begins at
+// items.values - front and holds front + items.capacity values
+typedef struct {
+  Obj obj;
+  ValueArray items;
+  int front;
+} ObjList;
+
 typedef struct {
   Obj obj;
   Map items;
 } ObjHashmap;
-
-typedef struct {
-  Obj obj;
-  ObjString* name;
-  Table methods;
-} ObjClass;
-
-typedef struct {
-  Obj obj;
-  ObjClass* klass;
-  Table fields;
-} ObjInstance;
-
+
+typedef struct {
+  Obj obj;
+  Set items;
+} ObjSet;
+
+typedef struct {
+  Obj obj;
+  Value key; // called on each pushed item for its priority, or nil
+  PriorityQueue items;
+} ObjPriorityQueue;
+
+// a fixed-length run of unboxed numbers; it holds no references, so the
+// collector never scans it
+typedef struct {
+  Obj obj;
+  int count;
+  double* values;
+} ObjFloatArray;
+
+// start, start + step, ... stopping before end. All three are integers, so
+// stepping by addition is exact; nothing is materialized.
+typedef struct {
+  Obj obj;
+  double start;
+  double end;
+  double step;
+} ObjRange;
+
+typedef enum {
+  SEQUENCE_MAP,
+  SEQUENCE_FILTER,
+} SequenceKind;
+
+// one lazy stage over a range or an earlier stage; nothing runs until the
+// sequence is iterated
+typedef struct {
+  Obj obj;
+  SequenceKind kind;
+  Value source;
+  Value function;
+} ObjSequence;
+
+// text assembled in place and interned only when built; the buffer is
+// counted toward the heap, and holds no references
+typedef struct {
+  Obj obj;
+  StringBuilder builder;
+} ObjStringBuilder;
+
+// a read-only view of a string's bytes as numbers; strings never change, so
+// it shares their characters instead of copying them
+typedef struct {
+  Obj obj;
+  ObjString* string;
+} ObjBytes;
+
+typedef struct {
+  Obj obj;
+  ObjString* name;
+  Table methods;
+} ObjClass;
+
+typedef struct {
+  Obj obj;
+  ObjClass* klass;
+  Table fields;
+} ObjInstance;
+
 typedef struct {
   Obj obj;
   Value receiver;
@@ -138,19 +222,34 @@ ObjClosure* newClosure(ObjFunction* function);
 ObjUpvalue* newUpvalue(Value* slot);
 ObjNative* newNative(NativeFn function);
 ObjNative* newHostNative(PbNativeFn function, void* userData);
-ObjString* takeString(char* chars, int length);
-ObjString* copyString(const char* chars, int length);
-ObjList* newList();
-ObjHashmap* newHashmap();
-ObjClass* newClass(ObjString* name);
-ObjInstance* newInstance(ObjClass* klass);
+ObjString* takeString(char* chars, int length);
+ObjString* copyString(const char* chars, int length);
+ObjList* newList();
+void freeList(ObjList* list);
+size_t listBytes(ObjList* list);
+bool listReserve(ObjList* list, int capacity);
+void listShrinkToFit(ObjList* list);
+bool listAppend(ObjList* list, Value value);
+void listInsertAt(ObjList* list, int index, Value value);
+Value listRemoveAt(ObjList* list, int index);
+void listClear(ObjList* list);
+ObjHashmap* newHashmap();
+ObjSet* newSet();
+ObjPriorityQueue* newPriorityQueue(Value key);
+ObjFloatArray* newFloatArray(int count);
+ObjRange* newRange(double start, double end, double step);
+ObjSequence* newSequence(SequenceKind kind, Value source, Value function);
+ObjStringBuilder* newStringBuilder();
+ObjBytes* newBytes(ObjString* string);
+ObjClass* newClass(ObjString* name);
+ObjInstance* newInstance(ObjClass* klass);
 ObjBoundMethod* newBoundMethod(Value receiver, ObjClosure* method);
 ObjModule* newModule(ObjString* name);
-void printObject(Value value);
-
-// function rather than just putting it in the macro coz this uses a value twice, that would cause the macro to be evaluated twice
-static inline bool isObjType(Value value, ObjType type) {
-  return IS_OBJ(value) && AS_OBJ(value)->type == type;
-}
-
+void printObject(Value value);
+
+// function rather than just putting it in the macro coz this uses a value twice, that would cause the macro to be evaluated twice
+static inline bool isObjType(Value value, ObjType type) {
+  return IS_OBJ(value) && AS_OBJ(value)->type == type;
+}
+
 #endif 
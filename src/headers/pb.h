@@ -10,7 +10,7 @@
 #define PB_API
 #endif
 
-#define PB_HOST_API_VERSION 3u
+#define PB_HOST_API_VERSION 13u
 
 typedef struct PbVM PbVM;
 
@@ -69,14 +69,91 @@ typedef PbValue (*PbNativeFn)(PbVM *vm, int argCount,
                               const PbValue *args,
                               void *userData);
 
+/* Allocation hook. A NULL pointer allocates and a zero newSize frees;
+   otherwise it behaves like realloc. oldSize is always the size of the
+   earlier request, so sized pools need no headers. */
+typedef void *(*PbReallocateFn)(void *pointer, size_t oldSize,
+                                size_t newSize, void *userData);
+typedef void (*PbReleaseFn)(void *userData);
+
+typedef struct
+{
+  PbReallocateFn reallocate; /* NULL uses the C library heap */
+  PbReleaseFn release;       /* optional; pbDestroyVM calls it instead of
+                                freeing each allocation */
+  void *userData;
+} PbAllocator;
+
+/* Garbage-collector pacing. Zero fields select the built-in defaults. */
+typedef struct
+{
+  size_t minHeapSize;      /* first collection threshold; default 1 MiB */
+  double heapGrowthFactor; /* next threshold = live bytes * factor; default 2 */
+  size_t maxHeapSize;      /* hard heap cap, a runtime error past it; 0 is unlimited */
+  double pauseTargetMs;    /* shrink the growth factor while pauses exceed it */
+} PbGCConfig;
+
 typedef struct
 {
   PbWriteFn write;
   PbDiagnosticFn diagnostic;
   PbCapabilityResolverFn resolveCapability;
   void *userData;
+  PbGCConfig gc;
+  PbAllocator allocator;
 } PbConfig;
 
+typedef enum
+{
+  PB_OBJECT_FUNCTION,
+  PB_OBJECT_CLOSURE,
+  PB_OBJECT_UPVALUE,
+  PB_OBJECT_NATIVE,
+  PB_OBJECT_STRING,
+  PB_OBJECT_LIST,
+  PB_OBJECT_MAP,
+  PB_OBJECT_CLASS,
+  PB_OBJECT_INSTANCE,
+  PB_OBJECT_BOUND_METHOD,
+  PB_OBJECT_MODULE,
+  PB_OBJECT_SET,
+  PB_OBJECT_PRIORITY_QUEUE,
+  PB_OBJECT_FLOAT_ARRAY,
+  PB_OBJECT_RANGE,
+  PB_OBJECT_SEQUENCE,
+  PB_OBJECT_STRING_BUILDER,
+  PB_OBJECT_BYTES,
+  PB_OBJECT_TYPE_COUNT
+} PbObjectType;
+
+/* Pause buckets are bounded by 0.1, 0.5, 1, 5, 10, 50 and 100 ms; the last
+   bucket counts every longer pause. */
+#define PB_GC_PAUSE_BUCKETS 8
+
+typedef struct
+{
+  size_t collections;
+  size_t bytesAllocated;
+  size_t nextCollection;
+  size_t liveBytes;
+  size_t lastBytesFreed;
+  size_t totalBytesFreed;
+  /* bytes held by the objects the last collection marked live */
+  size_t lastBytesMarked;
+  double lastPauseMs;
+  double maxPauseMs;
+  double totalPauseMs;
+  double heapGrowthFactor;
+  size_t pauseHistogram[PB_GC_PAUSE_BUCKETS];
+  size_t liveObjects[PB_OBJECT_TYPE_COUNT];
+  /* string interning set; probes count 16-slot groups visited per lookup */
+  size_t internedStrings;
+  size_t internCapacity;
+  size_t internTombstones;
+  size_t internMaxProbe;
+  double internAverageProbe;
+} PbGCStats;
+
 typedef struct
 {
   const char *name;
@@ -99,6 +176,12 @@ PB_API bool pbRegisterModuleSource(PbVM *vm,
                                    const char *name,
                                    const char *source);
 PB_API void pbRuntimeError(PbVM *vm, const char *message);
+PB_API void pbCollectGarbage(PbVM *vm);
+PB_API bool pbGetGCStats(PbVM *vm, PbGCStats *stats);
+/* Collects garbage, then writes every live object as one JSON record per
+   line: id, type, shallow size, retained size, immediate dominator, outgoing
+   references and an optional label. Id 0 is the root set. */
+PB_API bool pbWriteHeapSnapshot(PbVM *vm, PbWriteFn write, void *userData);
 
 PB_API PbValue pbNilValue(void);
 PB_API PbValue pbBoolValue(bool value);
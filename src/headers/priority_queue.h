@@ -0,0 +1,36 @@
+#ifndef PB_PRIORITY_QUEUE_H
+#define PB_PRIORITY_QUEUE_H
+
+#include "value.h"
+
+// A 4-ary min-heap. Priorities are stored unboxed next to their item, and a
+// queue holds either only numbers or only strings, so a comparison never has
+// to look at a type tag. Equal priorities leave in the order they arrived.
+typedef struct {
+  union {
+    double number;
+    ObjString* string;
+  } priority;
+  uint64_t order;
+  Value item;
+} QueueEntry;
+
+typedef struct {
+  int count;
+  int capacity;
+  bool strings;       // the kind of priority held; free to change when empty
+  uint64_t nextOrder;
+  QueueEntry* entries;
+} PriorityQueue;
+
+void initPriorityQueue(PriorityQueue* queue);
+void freePriorityQueue(PriorityQueue* queue);
+void markPriorityQueue(PriorityQueue* queue);
+size_t priorityQueueBytes(PriorityQueue* queue);
+bool priorityQueueAccepts(PriorityQueue* queue, Value priority);
+void priorityQueuePush(PriorityQueue* queue, Value priority, Value item);
+Value priorityQueuePop(PriorityQueue* queue);
+
+#define PRIORITY_QUEUE_PEEK(queue) ((queue)->entries[0].item)
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef PB_RANGE_H
+#define PB_RANGE_H
+
+#include "object.h"
+
+// the largest magnitude at which every integer is still a distinct number,
+// so a range bounded by it never stalls when stepped by addition
+#define RANGE_LIMIT 9007199254740992.0
+
+bool rangeArguments(int argCount, Value* args, double* start, double* end,
+                    double* step);
+double rangeCount(ObjRange* range);
+
+// Steps a range, or a chain of sequence stages over one. position counts
+// the range elements consumed so far and starts at 0. Stores the next
+// element and returns true; returns false at the end, or after a stage's
+// function raised a runtime error, which callers tell apart through
+// hadRuntimeError. The element is not rooted, so it must be pushed or
+// stored before anything else can allocate.
+bool sequenceNext(Value sequence, double* position, Value* element);
+
+#endif
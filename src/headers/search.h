@@ -0,0 +1,20 @@
+#ifndef PB_SEARCH_H
+#define PB_SEARCH_H
+
+#include "value.h"
+
+// Linear searches with the meaning of valuesEqual. Scalar, string and
+// identity needles are matched by comparing tags and payloads directly, a
+// few values at a time; only container needles need structural equality,
+// which can report a runtime error, so callers must check hadRuntimeError.
+int findValue(const Value* values, int count, Value needle);
+int countValue(const Value* values, int count, Value needle);
+
+// The first index at or after start where needle occurs in the length bytes
+// of haystack, or -1. Candidates are found by comparing the needle's first
+// and last bytes at sixteen positions at once, so most text is passed over
+// without a byte-by-byte loop. An empty needle is found at start.
+int findBytes(const char* haystack, int length, const char* needle,
+              int needleLength, int start);
+
+#endif
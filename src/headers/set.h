@@ -0,0 +1,33 @@
+#ifndef PB_SET_H
+#define PB_SET_H
+
+#include "value.h"
+
+// A Map without values: the keys alone sit dense and in insertion order
+// behind the same compact index. Keys are not stored with their hash, which
+// is cheap to recompute for the key types a set admits, so an element costs
+// one Value plus its index slots. Deleted keys stay as holes until the next
+// rebuild.
+typedef struct {
+  int count;         // live keys
+  int used;          // keys appended since the last rebuild, holes included
+  int capacity;      // keys that fit before a rebuild
+  int indexCapacity; // index slots, a power of two, 0 before the first add
+  Value* keys;       // start of the single allocation; the index follows
+  void* index;
+  uint32_t modifications; // bumped by every add, delete and rebuild
+} Set;
+
+void initSet(Set* set);
+void freeSet(Set* set);
+void markSet(Set* set);
+size_t setBytes(Set* set);
+bool setHas(Set* set, Value key);
+bool setAdd(Set* set, Value key);
+bool setDelete(Set* set, Value key);
+int setCount(Set* set);
+int setNextKey(Set* set, int position);
+
+#define SET_KEY_AT(set, position) ((set)->keys[position])
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef PB_SORT_H
+#define PB_SORT_H
+
+#include "value.h"
+
+// Sorts over runs of values that the caller has checked are all numbers or
+// all strings. They may allocate scratch space, and so collect; the values
+// must stay reachable. Out of memory, they leave the values as they were.
+void sortNumbers(Value* values, int count);
+void sortStrings(Value* values, int count);
+
+// Stores in order the indices of keys in sorted order, ascending or
+// descending. Keys that compare equal keep their relative order. False when
+// the scratch space is refused.
+bool sortOrder(Value* keys, int count, bool descending, int* order);
+
+#endif
@@ -4,25 +4,39 @@
 #include "common.h"
 #include "value.h"
 
+// Open addressing in the style of SwissTable: a byte of metadata per slot
+// holds either a 7-bit fragment of the key's hash or an empty/deleted marker,
+// so a probe can check a whole group of slots at once without touching the
+// keys. Keys and values live in separate arrays of the same allocation.
+#define TABLE_GROUP_WIDTH 16
+
 typedef struct {
-  ObjString* key;
-  Value value;
-} Entry;
+  int count;
+  int capacity;   // slots, a power of two, 0 before the first insert
+  int growthLeft; // empty slots that may still be filled before a rehash
+  Value* values;  // start of the single allocation backing the table
+  ObjString** keys;
+  uint8_t* control;
+} Table;
 
 typedef struct {
   int count;
   int capacity;
-  Entry* entries;
-} Table;
+  int tombstones;
+  int maxProbe;       // groups visited by the longest successful lookup
+  double averageProbe;
+} TableStats;
 
 void initTable(Table* table);
 void freeTable(Table* table);
+size_t tableBytes(Table* table);
 bool tableGet(Table* table, ObjString* key, Value* value);
 bool tableSet(Table* table, ObjString* key, Value value);
 bool tableDelete(Table* table, ObjString* key);
 void tableAddAll(Table* from, Table* to);
 ObjString* tableFindString(Table* table, const char* chars, int length, uint32_t hash);
 void tableRemoveWhite(Table* table);
+void tableGetStats(Table* table, TableStats* stats);
 void markTable(Table* table);
 
-#endif
\ No newline at end of file
+#endif
@@ -1,56 +1,82 @@
-#ifndef clox_value_h
-#define clox_value_h
-
-#include "common.h"
-
-typedef struct Obj Obj;
-typedef struct ObjString ObjString;
-
-typedef enum {
-  VAL_BOOL,
-  VAL_NIL,
-  VAL_NUMBER,
-  VAL_OBJ, // for storing stuff on the heap (pointer)
-} ValueType;
-
-typedef struct {
-  // one field to store the type
-  ValueType type;
-  // one field to store the union of all of the values it could store
-  union {
-    bool boolean;
-    double number;
-    Obj* obj;
-  } as;
-} Value;
-
-#define IS_BOOL(value)    ((value).type == VAL_BOOL)
-#define IS_NIL(value)     ((value).type == VAL_NIL)
-#define IS_NUMBER(value)  ((value).type == VAL_NUMBER)
-#define IS_OBJ(value)     ((value).type == VAL_OBJ)
-
-#define AS_BOOL(value)    ((value).as.boolean)
-#define AS_NUMBER(value)  ((value).as.number)
-#define AS_OBJ(value)     ((value).as.obj)
-
-#define BOOL_VAL(value)   ((Value){VAL_BOOL, {.boolean = value}})
-#define NIL_VAL           ((Value){VAL_NIL, {.number = 0}})
-#define NUMBER_VAL(value) ((Value){VAL_NUMBER, {.number = value}})
-#define OBJ_VAL(object)   ((Value){VAL_OBJ, {.obj = (Obj*)object}})
-
-//a constant pool of sorts, chunk stored opcode this one will store data
-typedef struct {
-  int capacity;
-  int count;
-  Value* values;
-} ValueArray;
-
-bool valuesEqual(Value a, Value b);
-//all the same functions as chunk as essentially the same task desired
-void initValueArray(ValueArray* array);
-void writeValueArray(ValueArray* array, Value value);
+#ifndef clox_value_h
+#define clox_value_h
+
+#include "common.h"
+
+typedef struct Obj Obj;
+typedef struct ObjString ObjString;
+
+typedef enum {
+  VAL_BOOL,
+  VAL_NIL,
+  VAL_NUMBER,
+  VAL_OBJ, // for storing stuff on the heap (pointer)
+} ValueType;
+
+typedef struct {
+  // one field to store the type
+  ValueType type;
+  // one field to store the union of all of the values it could store
+  union {
+    bool boolean;
+    double number;
+    Obj* obj;
+  } as;
+} Value;
+
+#define IS_BOOL(value)    ((value).type == VAL_BOOL)
+#define IS_NIL(value)     ((value).type == VAL_NIL)
+#define IS_NUMBER(value)  ((value).type == VAL_NUMBER)
+#define IS_OBJ(value)     ((value).type == VAL_OBJ)
+
+#define AS_BOOL(value)    ((value).as.boolean)
+#define AS_NUMBER(value)  ((value).as.number)
+#define AS_OBJ(value)     ((value).as.obj)
+
+#define BOOL_VAL(value)   ((Value){VAL_BOOL, {.boolean = value}})
+#define NIL_VAL           ((Value){VAL_NIL, {.number = 0}})
+#define NUMBER_VAL(value) ((Value){VAL_NUMBER, {.number = value}})
+#define OBJ_VAL(object)   ((Value){VAL_OBJ, {.obj = (Obj*)object}})
+
+//a constant pool of sorts, chunk stored opcode this one will store data
+typedef struct {
+  int capacity;
+  int count;
+  Value* values;
+} ValueArray;
+
+bool valuesEqual(Value a, Value b);
+
+// only nil and false are falsey
+static inline bool isFalsey(Value value) {
+  return IS_NIL(value) || (IS_BOOL(value) && !AS_BOOL(value));
+}
+
+//all the same functions as chunk as essentially the same task desired
+void initValueArray(ValueArray* array);
+void writeValueArray(ValueArray* array, Value value);
 void freeValueArray(ValueArray* array);
 void printValue(Value value);
 ObjString* valueToString(Value value);
-
+
+// A growable run of characters, always NUL terminated once anything has been
+// appended. active lists the containers being appended, so that cycles come
+// out as <cycle>. A counted builder belongs to a heap object: its characters
+// are charged to the collector and growing it may collect. Any other builder
+// lives outside the heap and never collects.
+typedef struct {
+  char* chars;
+  int count;
+  int capacity;
+  bool counted;
+  Obj** active;
+  int activeCount;
+  int activeCapacity;
+} StringBuilder;
+
+void appendChars(StringBuilder* builder, const char* chars, int length);
+// appends a value as print shows it
+void appendValue(StringBuilder* builder, Value value);
+void freeStringBuilder(StringBuilder* builder);
+
 #endif
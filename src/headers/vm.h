@@ -1,14 +1,15 @@
-#ifndef clox_vm_h
-#define clox_vm_h
-
-#include "object.h"
-#include "table.h"
-#include "value.h"
+#ifndef clox_vm_h
+#define clox_vm_h
+
+#include "memory.h"
+#include "object.h"
+#include "table.h"
+#include "value.h"
 #include "pb.h"
-
-#define FRAMES_MAX 64
-#define STACK_MAX (FRAMES_MAX * UINT8_COUNT)
-
+
+#define FRAMES_MAX 64
+#define STACK_MAX (FRAMES_MAX * UINT8_COUNT)
+
 typedef struct
 {
   ObjClosure *closure;
@@ -29,22 +30,30 @@ struct PbVM
   CallFrame frames[FRAMES_MAX];
   int frameCount;
   bool hadRuntimeError;
-
-  Value stack[STACK_MAX]; // time for implementing a stack in the virtual machine babyyyy also this is the pointer to the first element of the array by default (if we dont do any pointer arithmetic)
-  Value *stackTop;        // pointer to the element (pointer faster than indexing) just after the last stack, so pointing to 0 index means stack empty
+
+  Value stack[STACK_MAX]; // time for implementing a stack in the virtual machine babyyyy also this is the pointer to the first element of the array by default (if we dont do any pointer arithmetic)
+  Value *stackTop;        // pointer to the element (pointer faster than indexing) just after the last stack, so pointing to 0 index means stack empty
   Table globals;
   Table prelude;
   Table strings; // for interning strings, each unique string will only be stored once in memory, so "=" operation can be carried out fast -> just compare the memory address rather than comparing the string character by character
   Table modules;
   ObjString *initString;
+  ObjString *emptyString; // stands in for a string that could not be allocated
+  ObjString *byteStrings[256]; // every one-byte string, for chr, indexing and iteration
   ObjUpvalue *openUpvalues;
-
-  size_t bytesAllocated;
-  size_t nextGC;
-  Obj *objects;
+
+  size_t bytesAllocated;
+  size_t nextGC;
+  ObjPage *pages;
+  ObjPage *sparePage;
+  FreeSlot *freeSlots[OBJ_SIZE_CLASSES];
   int grayCount;
   int grayCapacity;
   Obj **grayStack;
+  bool grayStackOverflow;
+  bool collecting;
+  double gcGrowthFactor;
+  PbGCStats gcStats;
 
   PbConfig config;
   HostCapability *capabilities;
@@ -57,6 +66,16 @@ struct PbVM
 
 typedef PbVM VM;
 
+// A function a native calls once per element. Preparing it checks the callee
+// and its arity a single time, so each call of a closure is only a frame
+// push and a run of the interpreter loop.
+typedef struct
+{
+  Value callee;
+  ObjClosure *closure; // NULL for callees that go through callValue
+  int argCount;
+} NativeCallback;
+
 extern VM *activeVM;
 #define vm (*activeVM)
 
@@ -67,7 +86,10 @@ void runtimeError(const char *format, ...);
 void writeVMOutput(const char *text, size_t length);
 void reportDiagnostic(PbDiagnosticKind kind, const char *message);
 InterpretResult resolveModule(const char *name, Value *module);
+bool callFromNative(Value callee, int argCount, Value *args, Value *result);
+bool prepareCallback(NativeCallback *callback, Value callee, int argCount);
+bool invokeCallback(NativeCallback *callback, Value *args, Value *result);
 bool push(Value value);
 Value pop();
-
+
 #endif
@@ -0,0 +1,213 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host/heap_diff.h"
+
+#define HEAP_GROUP_NAME_MAX 64
+
+// Objects are grouped by type; instances and closures also by their class or
+// function name, which is usually what points at a leak.
+typedef struct
+{
+  char name[HEAP_GROUP_NAME_MAX];
+  size_t count[2];
+  size_t bytes[2];
+} HeapGroup;
+
+typedef struct
+{
+  HeapGroup *groups;
+  size_t count;
+  size_t capacity;
+} HeapGroups;
+
+static char *readSnapshot(const char *path)
+{
+  FILE *file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+
+  size_t length = 0;
+  size_t capacity = 4096;
+  char *buffer = (char *)malloc(capacity);
+  while (buffer != NULL)
+  {
+    length += fread(buffer + length, 1, capacity - length - 1, file);
+    if (length < capacity - 1)
+      break;
+    capacity *= 2;
+    char *grown = (char *)realloc(buffer, capacity);
+    if (grown == NULL)
+      free(buffer);
+    buffer = grown;
+  }
+  bool failed = ferror(file) != 0;
+  fclose(file);
+  if (buffer == NULL || failed)
+  {
+    free(buffer);
+    return NULL;
+  }
+  buffer[length] = '\0';
+  return buffer;
+}
+
+static bool readField(const char *line, const char *field, char *text,
+                      size_t capacity)
+{
+  const char *start = strstr(line, field);
+  if (start == NULL)
+    return false;
+  start += strlen(field);
+  size_t length = 0;
+  while (start[length] != '"' && start[length] != '\0' &&
+         start[length] != '\n')
+  {
+    if (start[length] == '\\' && start[length + 1] != '\0')
+      length++;
+    length++;
+  }
+  if (length >= capacity)
+    length = capacity - 1;
+  memcpy(text, start, length);
+  text[length] = '\0';
+  return true;
+}
+
+static bool readNumber(const char *line, const char *field, size_t *value)
+{
+  const char *start = strstr(line, field);
+  if (start == NULL)
+    return false;
+  *value = (size_t)strtoull(start + strlen(field), NULL, 10);
+  return true;
+}
+
+static HeapGroup *findGroup(HeapGroups *groups, const char *name)
+{
+  for (size_t i = 0; i < groups->count; i++)
+  {
+    if (strcmp(groups->groups[i].name, name) == 0)
+      return &groups->groups[i];
+  }
+
+  if (groups->count == groups->capacity)
+  {
+    size_t capacity = groups->capacity < 16 ? 16 : groups->capacity * 2;
+    HeapGroup *grown = (HeapGroup *)realloc(groups->groups,
+                                            sizeof(HeapGroup) * capacity);
+    if (grown == NULL)
+      return NULL;
+    groups->groups = grown;
+    groups->capacity = capacity;
+  }
+
+  HeapGroup *group = &groups->groups[groups->count++];
+  memset(group, 0, sizeof(*group));
+  snprintf(group->name, sizeof(group->name), "%.*s",
+           HEAP_GROUP_NAME_MAX - 1, name);
+  return group;
+}
+
+static bool addSnapshot(HeapGroups *groups, const char *path, int side)
+{
+  char *text = readSnapshot(path);
+  if (text == NULL)
+  {
+    fprintf(stderr, "Could not read heap snapshot \"%s\".\n", path);
+    return false;
+  }
+
+  bool sawHeader = strncmp(text, "{\"snapshot\":1,", 14) == 0;
+  for (char *line = text; sawHeader && *line != '\0';)
+  {
+    char *end = strchr(line, '\n');
+    if (end != NULL)
+      *end = '\0';
+
+    char type[HEAP_GROUP_NAME_MAX];
+    char label[HEAP_GROUP_NAME_MAX] = "";
+    size_t size;
+    if (strncmp(line, "{\"id\":", 6) == 0 &&
+        readField(line, "\"type\":\"", type, sizeof(type)) &&
+        strcmp(type, "root") != 0 &&
+        readNumber(line, "\"size\":", &size))
+    {
+      char name[HEAP_GROUP_NAME_MAX * 2];
+      if ((strcmp(type, "instance") == 0 || strcmp(type, "closure") == 0) &&
+          readField(line, "\"label\":\"", label, sizeof(label)))
+        snprintf(name, sizeof(name), "%s %s", type, label);
+      else
+        snprintf(name, sizeof(name), "%s", type);
+
+      HeapGroup *group = findGroup(groups, name);
+      if (group == NULL)
+      {
+        free(text);
+        return false;
+      }
+      group->count[side]++;
+      group->bytes[side] += size;
+    }
+
+    if (end == NULL)
+      break;
+    line = end + 1;
+  }
+
+  free(text);
+  if (!sawHeader)
+    fprintf(stderr, "\"%s\" is not a heap snapshot.\n", path);
+  return sawHeader;
+}
+
+static long long delta(const size_t values[2])
+{
+  return (long long)values[1] - (long long)values[0];
+}
+
+static int compareGroups(const void *left, const void *right)
+{
+  long long a = delta(((const HeapGroup *)left)->bytes);
+  long long b = delta(((const HeapGroup *)right)->bytes);
+  if (a != b)
+    return a < b ? 1 : -1;
+  return strcmp(((const HeapGroup *)left)->name,
+                ((const HeapGroup *)right)->name);
+}
+
+int diffHeapSnapshots(const char *beforePath, const char *afterPath,
+                      FILE *output)
+{
+  HeapGroups groups = {0};
+  if (!addSnapshot(&groups, beforePath, 0) ||
+      !addSnapshot(&groups, afterPath, 1))
+  {
+    free(groups.groups);
+    return 74;
+  }
+
+  qsort(groups.groups, groups.count, sizeof(HeapGroup), compareGroups);
+  HeapGroup total = {"total", {0, 0}, {0, 0}};
+  fprintf(output, "%-32s %10s %10s %12s %12s\n", "group", "count", "+/-",
+          "bytes", "+/-");
+  for (size_t i = 0; i < groups.count; i++)
+  {
+    HeapGroup *group = &groups.groups[i];
+    for (int side = 0; side < 2; side++)
+    {
+      total.count[side] += group->count[side];
+      total.bytes[side] += group->bytes[side];
+    }
+    fprintf(output, "%-32s %10zu %+10lld %12zu %+12lld\n", group->name,
+            group->count[1], delta(group->count), group->bytes[1],
+            delta(group->bytes));
+  }
+  fprintf(output, "%-32s %10zu %+10lld %12zu %+12lld\n", total.name,
+          total.count[1], delta(total.count), total.bytes[1],
+          delta(total.bytes));
+
+  free(groups.groups);
+  return 0;
+}
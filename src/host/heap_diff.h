@@ -0,0 +1,9 @@
+#ifndef PB_HOST_HEAP_DIFF_H
+#define PB_HOST_HEAP_DIFF_H
+
+#include <stdio.h>
+
+int diffHeapSnapshots(const char *beforePath, const char *afterPath,
+                      FILE *output);
+
+#endif
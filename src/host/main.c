@@ -8,6 +8,7 @@
 #include <readline/history.h>
 #endif
 
+#include "host/heap_diff.h"
 #include "host/module_loader.h"
 #include "headers/pb.h"
 
@@ -16,6 +17,8 @@ static void printUsage(FILE *stream)
   fprintf(stream,
           "Usage:\n"
           "  pb run [path]\n"
+          "  pb run --heap-snapshot <file> [path]\n"
+          "  pb heap-diff <before> <after>\n"
           "  pb repl\n"
           "  pb <path>\n");
 }
@@ -144,10 +147,35 @@ static int runFile(PbVM *vm, const char *path)
   return 0;
 }
 
+static void writeSnapshotChunk(PbVM *vm, const char *text, size_t length,
+                               void *userData)
+{
+  (void)vm;
+  fwrite(text, sizeof(char), length, (FILE *)userData);
+}
+
+static int writeHeapSnapshot(PbVM *vm, const char *path)
+{
+  FILE *file = fopen(path, "wb");
+  if (file == NULL)
+  {
+    fprintf(stderr, "Could not open file \"%s\".\n", path);
+    return 74;
+  }
+  bool written = pbWriteHeapSnapshot(vm, writeSnapshotChunk, file);
+  if (fclose(file) != 0 || !written)
+  {
+    fprintf(stderr, "Could not write heap snapshot \"%s\".\n", path);
+    return 74;
+  }
+  return 0;
+}
+
 int main(int argc, const char *argv[])
 {
   bool startRepl = argc == 1;
   const char *target = NULL;
+  const char *snapshotPath = NULL;
 
   if (argc == 2 &&
       (strcmp(argv[1], "help") == 0 || strcmp(argv[1], "--help") == 0 ||
@@ -165,14 +193,34 @@ int main(int argc, const char *argv[])
     }
     startRepl = true;
   }
+  else if (argc >= 2 && strcmp(argv[1], "heap-diff") == 0)
+  {
+    if (argc != 4)
+    {
+      printUsage(stderr);
+      return 64;
+    }
+    return diffHeapSnapshots(argv[2], argv[3], stdout);
+  }
   else if (argc >= 2 && strcmp(argv[1], "run") == 0)
   {
-    if (argc > 3)
+    int next = 2;
+    if (argc > next && strcmp(argv[next], "--heap-snapshot") == 0)
+    {
+      if (argc == next + 1)
+      {
+        printUsage(stderr);
+        return 64;
+      }
+      snapshotPath = argv[next + 1];
+      next += 2;
+    }
+    if (argc > next + 1)
     {
       printUsage(stderr);
       return 64;
     }
-    target = argc == 3 ? argv[2] : ".";
+    target = argc == next + 1 ? argv[next] : ".";
   }
   else if (argc == 2)
   {
@@ -220,6 +268,12 @@ int main(int argc, const char *argv[])
   else
   {
     status = runFile(vm, entryPath);
+    if (snapshotPath != NULL && status != 74)
+    {
+      int snapshotStatus = writeHeapSnapshot(vm, snapshotPath);
+      if (status == 0)
+        status = snapshotStatus;
+    }
   }
 
   pbDestroyVM(vm);
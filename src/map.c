@@ -1,12 +1,11 @@
 #include <math.h>
 #include <string.h>
 
+#include "headers/hash_index.h"
 #include "headers/map.h"
 #include "headers/memory.h"
 #include "headers/object.h"
 
-#define MAP_MAX_LOAD 0.75
-
 static uint32_t hashNumber(double number) {
   if (number == 0) number = 0;
 
@@ -20,13 +19,20 @@ static uint32_t hashNumber(double number) {
   return (uint32_t)(bits ^ (bits >> 32));
 }
 
-static uint32_t mapKeyHash(Value key) {
+// integer keys hash to themselves, so runs of small integers fill the index
+// without collisions; the perturbed probe copes with their patterns
+static inline bool isSmallInteger(double number) {
+  return number >= INT32_MIN && number <= INT32_MAX && number == (int32_t)number;
+}
+
+uint32_t mapKeyHash(Value key) {
   switch (key.type) {
     case VAL_NIL:
       return 0x9e3779b9u;
     case VAL_BOOL:
       return AS_BOOL(key) ? 0x85ebca6bu : 0xc2b2ae35u;
     case VAL_NUMBER:
+      if (isSmallInteger(AS_NUMBER(key))) return (uint32_t)(int32_t)AS_NUMBER(key);
       return hashNumber(AS_NUMBER(key));
     case VAL_OBJ:
       return AS_STRING(key)->hash;
@@ -35,79 +41,111 @@ static uint32_t mapKeyHash(Value key) {
   return 0;
 }
 
-static int findEntry(Map* map, Value key, uint32_t hash, int* previous) {
-  if (map->bucketCapacity == 0) return -1;
+// the index is kept at most half full, holes included
+static int usableEntries(int indexCapacity) {
+  return indexCapacity / 2;
+}
 
-  int bucket = (int)(hash & (uint32_t)(map->bucketCapacity - 1));
-  int current = map->buckets[bucket];
-  int prior = -1;
+static size_t storageBytes(int indexCapacity) {
+  if (indexCapacity == 0) return 0;
+  return (size_t)usableEntries(indexCapacity) * sizeof(MapEntry) +
+         hashIndexBytes(indexCapacity);
+}
 
-  while (current != -1) {
-    MapEntry* entry = &map->entries[current];
-    if (entry->hash == hash && valuesEqual(entry->key, key)) {
-      if (previous != NULL) *previous = prior;
-      return current;
-    }
-    prior = current;
-    current = entry->nextBucket;
-  }
+size_t mapBytes(Map* map) {
+  return storageBytes(map->indexCapacity);
+}
 
-  if (previous != NULL) *previous = prior;
-  return -1;
+static inline int getIndex(Map* map, int slot) {
+  return hashIndexGet(map->index, map->indexCapacity, slot);
 }
 
-static void adjustBucketCapacity(Map* map, int capacity) {
-  int* buckets = ALLOCATE(int, capacity);
-  for (int i = 0; i < capacity; i++) {
-    buckets[i] = -1;
-  }
+static inline void setIndex(Map* map, int slot, int entryIndex) {
+  hashIndexSet(map->index, map->indexCapacity, slot, entryIndex);
+}
 
-  for (int i = 0; i < map->used; i++) {
-    MapEntry* entry = &map->entries[i];
-    if (!entry->occupied) continue;
+// the index slot holding key, or -1
+static int findSlot(Map* map, Value key, uint32_t hash) {
+  if (map->indexCapacity == 0) return -1;
+
+  uint32_t mask = (uint32_t)map->indexCapacity - 1;
+  uint32_t perturb = hash;
+  for (uint32_t slot = hash & mask;; HASH_INDEX_NEXT(slot, perturb, mask)) {
+    int entryIndex = getIndex(map, (int)slot);
+    if (entryIndex == HASH_INDEX_EMPTY) return -1;
+    if (entryIndex == HASH_INDEX_DELETED) continue;
 
-    int bucket = (int)(entry->hash & (uint32_t)(capacity - 1));
-    entry->nextBucket = buckets[bucket];
-    buckets[bucket] = i;
+    if (hashKeysMatch(map->entries[entryIndex].key, key)) return (int)slot;
   }
+}
 
-  FREE_ARRAY(int, map->buckets, map->bucketCapacity);
-  map->buckets = buckets;
-  map->bucketCapacity = capacity;
+static int findEmptySlot(Map* map, uint32_t hash) {
+  return hashIndexFindEmpty(map->index, map->indexCapacity, hash);
 }
 
-static int allocateEntry(Map* map) {
-  if (map->freeList != -1) {
-    int index = map->freeList;
-    map->freeList = map->entries[index].nextBucket;
-    return index;
-  }
+// in a dense map entry i holds the key i, for every entry, so integer keys
+// are found by position and anything else is known to be absent
+static inline bool isDenseKey(Value key, int position) {
+  return IS_NUMBER(key) && AS_NUMBER(key) == position;
+}
+
+static inline int denseEntry(Map* map, Value key) {
+  if (!IS_NUMBER(key)) return -1;
+  double number = AS_NUMBER(key);
+  if (number < 0 || number >= map->used || number != (int)number) return -1;
+  return (int)number;
+}
+
+// moves the live entries to the front of a fresh allocation, in order, and
+// indexes them again, which also drops every deleted index slot; the map
+// is left as it was when the new storage is refused
+static bool rebuild(Map* map, int liveTarget) {
+  int indexCapacity = HASH_INDEX_MIN;
+  while (usableEntries(indexCapacity) < liveTarget) indexCapacity *= 2;
+
+  char* storage = ALLOCATE(char, storageBytes(indexCapacity));
+  if (storage == NULL) return false;
+  Map rebuilt;
+  rebuilt.count = map->count;
+  rebuilt.modifications = map->modifications + 1;
+  rebuilt.used = 0;
+  rebuilt.dense = true;
+  rebuilt.capacity = usableEntries(indexCapacity);
+  rebuilt.indexCapacity = indexCapacity;
+  rebuilt.entries = (MapEntry*)storage;
+  rebuilt.index = storage + (size_t)rebuilt.capacity * sizeof(MapEntry);
+  hashIndexClear(rebuilt.index, indexCapacity);
 
-  if (map->used == map->capacity) {
-    int oldCapacity = map->capacity;
-    map->capacity = GROW_CAPACITY(oldCapacity);
-    map->entries = GROW_ARRAY(MapEntry, map->entries, oldCapacity, map->capacity);
+  for (int i = 0; i < map->used; i++) {
+    MapEntry* entry = &map->entries[i];
+    if (!entry->occupied) continue;
+    setIndex(&rebuilt, findEmptySlot(&rebuilt, entry->hash), rebuilt.used);
+    if (!isDenseKey(entry->key, rebuilt.used)) rebuilt.dense = false;
+    rebuilt.entries[rebuilt.used++] = *entry;
   }
 
-  return map->used++;
+  FREE_ARRAY(char, map->entries, storageBytes(map->indexCapacity));
+  *map = rebuilt;
+  return true;
 }
 
 void initMap(Map* map) {
   map->count = 0;
-  map->capacity = 0;
   map->used = 0;
-  map->bucketCapacity = 0;
-  map->firstOrder = -1;
-  map->lastOrder = -1;
-  map->freeList = -1;
+  map->dense = true;
+  map->capacity = 0;
+  map->indexCapacity = 0;
   map->entries = NULL;
-  map->buckets = NULL;
+  map->index = NULL;
+  map->modifications = 0;
 }
 
+// the count of modifications carries on, since emptying a map is one too
 void freeMap(Map* map) {
-  FREE_ARRAY(MapEntry, map->entries, map->capacity);
-  FREE_ARRAY(int, map->buckets, map->bucketCapacity);
+  FREE_ARRAY(char, map->entries, storageBytes(map->indexCapacity));
+  uint32_t modifications = map->modifications;
   initMap(map);
+  map->modifications = modifications + 1;
 }
 
 bool mapKeyIsValid(Value key) {
@@ -119,48 +157,58 @@ bool mapKeyIsValid(Value key) {
 bool mapGet(Map* map, Value key, Value* value) {
   if (!mapKeyIsValid(key)) return false;
 
-  int index = findEntry(map, key, mapKeyHash(key), NULL);
-  if (index == -1) return false;
+  if (map->dense) {
+    int entryIndex = denseEntry(map, key);
+    if (entryIndex == -1) return false;
+    *value = map->entries[entryIndex].value;
+    return true;
+  }
+
+  int slot = findSlot(map, key, mapKeyHash(key));
+  if (slot == -1) return false;
 
-  *value = map->entries[index].value;
+  *value = map->entries[getIndex(map, slot)].value;
   return true;
 }
 
 bool mapSet(Map* map, Value key, Value value, bool* isNewKey) {
   if (!mapKeyIsValid(key)) return false;
 
+  if (map->dense) {
+    int entryIndex = denseEntry(map, key);
+    if (entryIndex != -1) {
+      map->entries[entryIndex].value = value;
+      if (isNewKey != NULL) *isNewKey = false;
+      return true;
+    }
+  }
+
   uint32_t hash = mapKeyHash(key);
-  int existing = findEntry(map, key, hash, NULL);
-  if (existing != -1) {
-    map->entries[existing].value = value;
+  int slot = map->dense ? -1 : findSlot(map, key, hash);
+  if (slot != -1) {
+    map->entries[getIndex(map, slot)].value = value;
     if (isNewKey != NULL) *isNewKey = false;
     return true;
   }
 
-  if (map->count + 1 > map->bucketCapacity * MAP_MAX_LOAD) {
-    adjustBucketCapacity(map, GROW_CAPACITY(map->bucketCapacity));
+  // out of entries: the rebuild leaves room for as many inserts again as
+  // there are live keys, so holes left by deletes are reclaimed before the
+  // entries double
+  if (map->used == map->capacity &&
+      !rebuild(map, map->count == 0 ? 1 : map->count * 2)) {
+    return false;
   }
 
-  int index = allocateEntry(map);
-  MapEntry* entry = &map->entries[index];
-  int bucket = (int)(hash & (uint32_t)(map->bucketCapacity - 1));
-
+  MapEntry* entry = &map->entries[map->used];
   entry->key = key;
   entry->value = value;
   entry->hash = hash;
-  entry->nextBucket = map->buckets[bucket];
-  entry->previousOrder = map->lastOrder;
-  entry->nextOrder = -1;
   entry->occupied = true;
-
-  map->buckets[bucket] = index;
-  if (map->lastOrder != -1) {
-    map->entries[map->lastOrder].nextOrder = index;
-  } else {
-    map->firstOrder = index;
-  }
-  map->lastOrder = index;
+  setIndex(map, findEmptySlot(map, hash), map->used);
+  if (!isDenseKey(key, map->used)) map->dense = false;
+  map->used++;
   map->count++;
+  map->modifications++;
 
   if (isNewKey != NULL) *isNewKey = true;
   return true;
@@ -169,38 +217,24 @@ bool mapSet(Map* map, Value key, Value value, bool* isNewKey) {
 bool mapDelete(Map* map, Value key) {
   if (!mapKeyIsValid(key)) return false;
 
-  uint32_t hash = mapKeyHash(key);
-  int previousBucket = -1;
-  int index = findEntry(map, key, hash, &previousBucket);
-  if (index == -1) return false;
-
-  MapEntry* entry = &map->entries[index];
-  int bucket = (int)(hash & (uint32_t)(map->bucketCapacity - 1));
-  if (previousBucket == -1) {
-    map->buckets[bucket] = entry->nextBucket;
-  } else {
-    map->entries[previousBucket].nextBucket = entry->nextBucket;
-  }
-
-  if (entry->previousOrder != -1) {
-    map->entries[entry->previousOrder].nextOrder = entry->nextOrder;
-  } else {
-    map->firstOrder = entry->nextOrder;
-  }
-  if (entry->nextOrder != -1) {
-    map->entries[entry->nextOrder].previousOrder = entry->previousOrder;
-  } else {
-    map->lastOrder = entry->previousOrder;
-  }
+  int slot = findSlot(map, key, mapKeyHash(key));
+  if (slot == -1) return false;
 
+  MapEntry* entry = &map->entries[getIndex(map, slot)];
   entry->key = NIL_VAL;
   entry->value = NIL_VAL;
   entry->occupied = false;
-  entry->nextBucket = map->freeList;
-  entry->previousOrder = -1;
-  entry->nextOrder = -1;
-  map->freeList = index;
+  setIndex(map, slot, HASH_INDEX_DELETED);
   map->count--;
+  map->dense = false;
+  map->modifications++;
+
+  // keep a scan over the entries proportional to the live keys
+  if (map->count == 0) {
+    freeMap(map);
+  } else if (map->used > HASH_INDEX_MIN && map->count < map->used / 4) {
+    rebuild(map, map->count * 2);
+  }
   return true;
 }
 
@@ -208,16 +242,45 @@ void mapClear(Map* map) {
   freeMap(map);
 }
 
+// copies the storage of from wholesale, holes and all; to must be empty
+void mapCopy(Map* from, Map* to) {
+  if (from->indexCapacity == 0) return;
+
+  size_t bytes = storageBytes(from->indexCapacity);
+  char* storage = ALLOCATE(char, bytes);
+  if (storage == NULL) return;
+  memcpy(storage, from->entries, bytes);
+  *to = *from;
+  to->entries = (MapEntry*)storage;
+  to->index = storage + ((char*)from->index - (char*)from->entries);
+}
+
+// rebuilding also compacts the holes, so both leave used == count
+void mapReserve(Map* map, int count) {
+  if (count > map->capacity) rebuild(map, count);
+}
+
+void mapShrinkToFit(Map* map) {
+  if (map->count == 0) {
+    freeMap(map);
+  } else {
+    rebuild(map, map->count);
+  }
+}
+
 int mapCount(Map* map) {
   return map->count;
 }
 
 int mapFirstEntry(Map* map) {
-  return map->firstOrder;
+  return mapNextEntry(map, -1);
 }
 
 int mapNextEntry(Map* map, int entryIndex) {
-  return map->entries[entryIndex].nextOrder;
+  for (int i = entryIndex + 1; i < map->used; i++) {
+    if (map->entries[i].occupied) return i;
+  }
+  return -1;
 }
 
 MapEntry* mapEntryAt(Map* map, int entryIndex) {
@@ -225,8 +288,9 @@ MapEntry* mapEntryAt(Map* map, int entryIndex) {
 }
 
 void markMap(Map* map) {
-  for (int index = map->firstOrder; index != -1; index = map->entries[index].nextOrder) {
-    MapEntry* entry = &map->entries[index];
+  for (int i = 0; i < map->used; i++) {
+    MapEntry* entry = &map->entries[i];
+    if (!entry->occupied) continue;
     markValue(entry->key);
     markValue(entry->value);
   }
@@ -1,75 +1,270 @@
-#include <stdlib.h>
-
-#include "headers/compiler.h"
-#include "headers/memory.h"
-#include "headers/vm.h"
-
-#ifdef DEBUG_LOG_GC
-#include <stdio.h>
-#include "headers/debug.h"
-#endif
-
-#define GC_HEAP_GROW_FACTOR 2
-
-void* reallocate(void* pointer, size_t oldSize, size_t newSize) {
-  vm.bytesAllocated += newSize - oldSize;
-  if (newSize > oldSize) {
-    #ifdef DEBUG_STRESS_GC
-      printf("Total memory allocated: %d", vm.bytesAllocated);
-      collectGarbage();
-    #endif
-    if (vm.bytesAllocated > vm.nextGC) {
-      collectGarbage();
-    }
-  }
-  if (newSize == 0) {
-    free(pointer);
-    return NULL;
-  }
-
-  void* result = realloc(pointer, newSize);
-  if (result == NULL) exit(1);
-  return result;
-}
-
-void markObject(Obj* object) {
-  if (object == NULL) return;
-  if (object->isMarked) return; //prevent infinite loop
-
-#ifdef DEBUG_LOG_GC
-  printf("%p mark ", (void*)object);
-  printValue(OBJ_VAL(object));
-  printf("\n");
-#endif
-  object->isMarked = true;
-
-  if (vm.grayCapacity < vm.grayCount + 1) {
-    vm.grayCapacity = GROW_CAPACITY(vm.grayCapacity);
-    vm.grayStack = (Obj**)realloc(vm.grayStack, sizeof(Obj*) * vm.grayCapacity);
-  
-    if (vm.grayStack == NULL) exit(1); //not enough memory to allocate the graystack 
-  }
-
-  vm.grayStack[vm.grayCount++] = object;
-}
-
-void markValue(Value value) {
-  if (IS_OBJ(value)) markObject(AS_OBJ(value)); // no need to worry about stuff that isnt heap allocated
-}
-
-static void markArray(ValueArray* array) {
-  for (int i = 0; i < array->count; i++) {
-    markValue(array->values[i]);
-  }
-}
-
-static void blackenObject(Obj* object) {
-#ifdef DEBUG_LOG_GC
-  printf("%p blacken ", (void*)object);
-  printValue(OBJ_VAL(object));
-  printf("\n");
-#endif
-  switch (object->type) {
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "headers/compiler.h"
+#include "headers/memory.h"
+#include "headers/vm.h"
+
+#ifdef DEBUG_LOG_GC
+#include <stdio.h>
+#include "headers/debug.h"
+#endif
+
+#define GC_HEAP_GROW_FACTOR 2
+#define GC_MIN_HEAP_SIZE (1024 * 1024)
+#define GC_MIN_GROW_FACTOR 1.25
+
+// VM bookkeeping outside the GC heap: goes through the host allocator like
+// everything else but is not counted toward collection thresholds
+void* rawReallocate(void* pointer, size_t oldSize, size_t newSize) {
+  if (pointer == NULL && newSize == 0) return NULL;
+  PbAllocator* allocator = &vm.config.allocator;
+  if (allocator->reallocate != NULL) {
+    return allocator->reallocate(pointer, oldSize, newSize, allocator->userData);
+  }
+  if (newSize == 0) {
+    free(pointer);
+    return NULL;
+  }
+  return realloc(pointer, newSize);
+}
+
+static bool overHeapLimit(size_t bytes) {
+  return vm.config.gc.maxHeapSize > 0 && bytes > vm.config.gc.maxHeapSize;
+}
+
+static void heapLimitExceeded(void) {
+  runtimeError("Out of memory: heap limit of %zu bytes exceeded.",
+               vm.config.gc.maxHeapSize);
+}
+
+// charges the heap before anything is allocated, so a request that would
+// take it past the cap is refused with a runtime error instead of made.
+// Once a runtime error is raised the stack has already been reset, so any
+// object the current instruction still holds in a C local is unreachable:
+// no collection runs until the error has unwound and the flag is cleared
+static void collectBeforeAllocating(size_t growth) {
+  // the sweep itself may allocate, when the interning table is compacted
+  if (vm.hadRuntimeError || vm.collecting) return;
+
+  bool collected = false;
+  #ifdef DEBUG_STRESS_GC
+    printf("Total memory allocated: %d", vm.bytesAllocated);
+    collectGarbage();
+    collected = true;
+  #endif
+  if (vm.bytesAllocated + growth > vm.nextGC) {
+    collectGarbage();
+    collected = true;
+  }
+  if (!collected && overHeapLimit(vm.bytesAllocated + growth)) {
+    collectGarbage();
+  }
+}
+
+static bool trackAllocation(size_t oldSize, size_t newSize) {
+  if (newSize <= oldSize) {
+    vm.bytesAllocated -= oldSize - newSize;
+    return true;
+  }
+
+  size_t growth = newSize - oldSize;
+  if (vm.collecting) {
+    vm.bytesAllocated += growth;
+    return true;
+  }
+  collectBeforeAllocating(growth);
+  if (overHeapLimit(vm.bytesAllocated + growth)) {
+    heapLimitExceeded();
+    return false;
+  }
+  vm.bytesAllocated += growth;
+  return true;
+}
+
+// a host allocator that runs dry gets one retry after a collection; after
+// that the script is aborted with the same error as the heap cap
+static void* rawReallocateOrCollect(void* pointer, size_t oldSize, size_t newSize) {
+  void* result = rawReallocate(pointer, oldSize, newSize);
+  if (result == NULL && !vm.hadRuntimeError && !vm.collecting) {
+    collectGarbage();
+    result = rawReallocate(pointer, oldSize, newSize);
+  }
+  if (result == NULL) {
+    runtimeError("Out of memory: the allocator could not provide %zu bytes.",
+                 newSize);
+  }
+  return result;
+}
+
+// returns NULL, with a runtime error raised, when the memory is refused; a
+// block that failed to grow is left as it was
+void* reallocate(void* pointer, size_t oldSize, size_t newSize) {
+  if (newSize == 0) {
+    trackAllocation(oldSize, 0);
+    rawReallocate(pointer, oldSize, 0);
+    return NULL;
+  }
+  if (!trackAllocation(oldSize, newSize)) return NULL;
+
+  void* result = rawReallocateOrCollect(pointer, oldSize, newSize);
+  if (result == NULL) vm.bytesAllocated -= newSize - oldSize;
+  return result;
+}
+
+// every size-class page is OBJ_PAGE_SIZE bytes, so any of them can stand in
+// for another; an object too big for the size classes is a page of its own
+// holding just that object
+static size_t pageBytes(size_t slotSize) {
+  if (slotSize / 8 >= OBJ_SIZE_CLASSES) return sizeof(ObjPage) + slotSize;
+  return OBJ_PAGE_SIZE;
+}
+
+// object constructors cannot fail, so one page is held back for the
+// instruction that finds the host allocator dry; it is refilled as soon as
+// no error is pending
+bool reserveSparePage(void) {
+  if (vm.sparePage == NULL) {
+    vm.sparePage = (ObjPage*)rawReallocate(NULL, 0, OBJ_PAGE_SIZE);
+  }
+  return vm.sparePage != NULL;
+}
+
+// the heap is charged whole pages, since that is what the allocator hands
+// out. A page past the cap is still made, because constructors cannot fail;
+// the error stops the script at the end of the instruction
+static ObjPage* newPage(size_t slotSize) {
+  size_t bytes = pageBytes(slotSize);
+  size_t slotCount = (bytes - sizeof(ObjPage)) / slotSize;
+  vm.bytesAllocated += bytes;
+  if (overHeapLimit(vm.bytesAllocated)) heapLimitExceeded();
+
+  if (!vm.hadRuntimeError) reserveSparePage();
+  ObjPage* page = (ObjPage*)rawReallocateOrCollect(NULL, 0, bytes);
+  if (page == NULL) {
+    // nothing is left to hand out: give up as a failed malloc always has
+    if (vm.sparePage == NULL || bytes != OBJ_PAGE_SIZE) exit(1);
+    page = vm.sparePage;
+    vm.sparePage = NULL;
+  }
+
+  page->next = vm.pages;
+  page->slotSize = (uint32_t)slotSize;
+  page->slotCount = (uint32_t)slotCount;
+  vm.pages = page;
+
+  for (uint32_t i = 0; i < page->slotCount; i++) {
+    PAGE_SLOT(page, i)->type = OBJ_FREE;
+  }
+  return page;
+}
+
+Obj* allocateObjectSlot(size_t size) {
+  size_t slotSize = (size + 7) & ~(size_t)7;
+  if (slotSize < sizeof(FreeSlot)) slotSize = sizeof(FreeSlot);
+  size_t sizeClass = slotSize / 8;
+  bool large = sizeClass >= OBJ_SIZE_CLASSES;
+
+  // collect first: the sweep rebuilds the free lists, and may leave a slot
+  // that saves a new page
+  collectBeforeAllocating(large || vm.freeSlots[sizeClass] == NULL
+                              ? pageBytes(slotSize) : 0);
+  if (large) return PAGE_SLOT(newPage(slotSize), 0);
+
+  if (vm.freeSlots[sizeClass] == NULL) {
+    ObjPage* page = newPage(slotSize);
+    for (uint32_t i = page->slotCount; i > 0; i--) {
+      FreeSlot* slot = (FreeSlot*)PAGE_SLOT(page, i - 1);
+      slot->next = vm.freeSlots[sizeClass];
+      vm.freeSlots[sizeClass] = slot;
+    }
+  }
+
+  FreeSlot* slot = vm.freeSlots[sizeClass];
+  vm.freeSlots[sizeClass] = slot->next;
+  return (Obj*)slot;
+}
+
+bool heapContainsObject(const void* pointer) {
+  const char* address = (const char*)pointer;
+  for (ObjPage* page = vm.pages; page != NULL; page = page->next) {
+    const char* first = (const char*)PAGE_SLOT(page, 0);
+    if (address < first || address >= (const char*)PAGE_SLOT(page, page->slotCount)) {
+      continue;
+    }
+    return (size_t)(address - first) % page->slotSize == 0 &&
+           ((const Obj*)pointer)->type != OBJ_FREE;
+  }
+  return false;
+}
+
+// while a visitor is installed the marking functions report each reference
+// instead of marking it, which lets heap tools reuse the GC's own tracing
+static ObjectVisitor activeVisitor = NULL;
+static void* activeVisitorContext = NULL;
+
+void markObject(Obj* object) {
+  if (object == NULL) return;
+  if (activeVisitor != NULL) {
+    activeVisitor(object, activeVisitorContext);
+    return;
+  }
+  if (object->isMarked) return; //prevent infinite loop
+
+#ifdef DEBUG_LOG_GC
+  printf("%p mark ", (void*)object);
+  printValue(OBJ_VAL(object));
+  printf("\n");
+#endif
+  object->isMarked = true;
+
+  // objects without references are black as soon as they are marked
+  if (object->type == OBJ_STRING || object->type == OBJ_NATIVE ||
+      object->type == OBJ_FLOAT_ARRAY || object->type == OBJ_RANGE ||
+      object->type == OBJ_STRING_BUILDER) {
+    return;
+  }
+
+  if (vm.grayCapacity < vm.grayCount + 1) {
+    int capacity = GROW_CAPACITY(vm.grayCapacity);
+    Obj** grayStack = (Obj**)rawReallocate(vm.grayStack,
+                                           sizeof(Obj*) * vm.grayCapacity,
+                                           sizeof(Obj*) * capacity);
+
+    // the object stays marked but ungrayed; traceReferences finds it again
+    // by rescanning the heap instead of giving up on the collection
+    if (grayStack == NULL) {
+      vm.grayStackOverflow = true;
+      return;
+    }
+    vm.grayStack = grayStack;
+    vm.grayCapacity = capacity;
+  }
+
+  vm.grayStack[vm.grayCount++] = object;
+}
+
+void markValue(Value value) {
+  if (IS_OBJ(value)) markObject(AS_OBJ(value)); // no need to worry about stuff that isnt heap allocated
+}
+
+static void markArray(ValueArray* array) {
+  for (int i = 0; i < array->count; i++) {
+    markValue(array->values[i]);
+  }
+}
+
+static void blackenObject(Obj* object) {
+#ifdef DEBUG_LOG_GC
+  printf("%p blacken ", (void*)object);
+  printValue(OBJ_VAL(object));
+  printf("\n");
+#endif
+  switch (object->type) {
     case OBJ_FUNCTION: {
       ObjFunction* function = (ObjFunction*)object;
       markObject((Obj*)function->name);
@@ -99,10 +294,10 @@ static void blackenObject(Obj* object) {
       markMap(&map->items);
       break;
     }
-    case OBJ_NATIVE:
-      break;
-    case OBJ_STRING:
-      break;
+    case OBJ_NATIVE:
+      break;
+    case OBJ_STRING:
+      break;
     case OBJ_CLASS: {
       ObjClass* klass = (ObjClass*)object;
       markObject((Obj*)klass->name);
@@ -128,119 +323,314 @@ static void blackenObject(Obj* object) {
       markTable(&module->exports);
       break;
     }
-  }
-}
-
-static void markRoots();
-static void traceReferences();
-static void sweep();
-
-void collectGarbage() {
-#ifdef DEBUG_LOG_GC
-  printf("--gc begin\n");
-  size_t before = vm.bytesAllocated;
-#endif
-
-  markRoots();
-  traceReferences();
-  tableRemoveWhite(&vm.strings);
-  sweep();
-
-  vm.nextGC = vm.bytesAllocated * GC_HEAP_GROW_FACTOR;
-
-#ifdef DEBUG_LOG_GC
-  printf("--gc end\n");
-  printf("   collected %zu bytes (from %zu to %zu) next at %zu\n",
-         before - vm.bytesAllocated, before, vm.bytesAllocated,
-         vm.nextGC);
-  #endif
-
-}
-
-static void freeObject(Obj* object) {
-#ifdef DEBUG_LOG_GC
-  printf("%p free type %d\n", (void*)object, object->type);
-#endif
-
-  switch (object->type) {
+    case OBJ_SET:
+      markSet(&((ObjSet*)object)->items);
+      break;
+    case OBJ_PRIORITY_QUEUE: {
+      ObjPriorityQueue* queue = (ObjPriorityQueue*)object;
+      markValue(queue->key);
+      markPriorityQueue(&queue->items);
+      break;
+    }
+    case OBJ_FLOAT_ARRAY:
+    case OBJ_RANGE:
+    case OBJ_STRING_BUILDER:
+      break;
+    case OBJ_BYTES:
+      markObject((Obj*)((ObjBytes*)object)->string);
+      break;
+    case OBJ_SEQUENCE: {
+      ObjSequence* sequence = (ObjSequence*)object;
+      markValue(sequence->source);
+      markValue(sequence->function);
+      break;
+    }
+  }
+}
+
+static void markRoots();
+static void traceReferences();
+static size_t sweep();
+
+void visitRoots(ObjectVisitor visitor, void* context) {
+  activeVisitor = visitor;
+  activeVisitorContext = context;
+  markRoots();
+  activeVisitor = NULL;
+  activeVisitorContext = NULL;
+}
+
+void visitReferences(Obj* object, ObjectVisitor visitor, void* context) {
+  activeVisitor = visitor;
+  activeVisitorContext = context;
+  blackenObject(object);
+  activeVisitor = NULL;
+  activeVisitorContext = NULL;
+}
+
+// heap bytes an object owns beyond its slot, matching what freeObject releases
+size_t objectOwnedBytes(Obj* object) {
+  switch (object->type) {
+    case OBJ_FUNCTION: {
+      Chunk* chunk = &((ObjFunction*)object)->chunk;
+      return (size_t)chunk->capacity * (sizeof(uint8_t) + sizeof(int)) +
+             (size_t)chunk->constants.capacity * sizeof(Value);
+    }
+    case OBJ_CLOSURE:
+      return (size_t)((ObjClosure*)object)->upvalueCount * sizeof(ObjUpvalue*);
+    case OBJ_STRING:
+      return (size_t)((ObjString*)object)->length + 1;
+    case OBJ_LIST:
+      return listBytes((ObjList*)object);
+    case OBJ_HASHMAP:
+      return mapBytes(&((ObjHashmap*)object)->items);
+    case OBJ_CLASS:
+      return tableBytes(&((ObjClass*)object)->methods);
+    case OBJ_INSTANCE:
+      return tableBytes(&((ObjInstance*)object)->fields);
+    case OBJ_MODULE: {
+      ObjModule* module = (ObjModule*)object;
+      return tableBytes(&module->globals) + tableBytes(&module->exports);
+    }
+    case OBJ_SET:
+      return setBytes(&((ObjSet*)object)->items);
+    case OBJ_PRIORITY_QUEUE:
+      return priorityQueueBytes(&((ObjPriorityQueue*)object)->items);
+    case OBJ_FLOAT_ARRAY:
+      return sizeof(double) * (size_t)((ObjFloatArray*)object)->count;
+    case OBJ_STRING_BUILDER:
+      return (size_t)((ObjStringBuilder*)object)->builder.capacity;
+    case OBJ_UPVALUE:
+    case OBJ_NATIVE:
+    case OBJ_BOUND_METHOD:
+    case OBJ_RANGE:
+    case OBJ_SEQUENCE:
+    case OBJ_BYTES:
+      return 0;
+  }
+  return 0;
+}
+
+static double configuredGrowthFactor(void) {
+  double factor = vm.config.gc.heapGrowthFactor;
+  return factor > 1.0 ? factor : GC_HEAP_GROW_FACTOR;
+}
+
+size_t initialGCThreshold(void) {
+  size_t minimum = vm.config.gc.minHeapSize > 0 ? vm.config.gc.minHeapSize
+                                                : GC_MIN_HEAP_SIZE;
+  vm.gcGrowthFactor = configuredGrowthFactor();
+  if (vm.config.gc.maxHeapSize > 0 && minimum > vm.config.gc.maxHeapSize) {
+    minimum = vm.config.gc.maxHeapSize;
+  }
+  return minimum;
+}
+
+// pauses are wall-clock time on a monotonic clock; clock() would report the
+// process's CPU time and miss any time the collector spends off the CPU
+static double monotonicMs(void) {
+  struct timespec now;
+#ifdef _WIN32
+  timespec_get(&now, TIME_UTC);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+  return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+static void recordPause(double pauseMs, size_t before, size_t marked) {
+  static const double bucketLimits[PB_GC_PAUSE_BUCKETS - 1] = {
+    0.1, 0.5, 1, 5, 10, 50, 100
+  };
+  PbGCStats* stats = &vm.gcStats;
+  int bucket = 0;
+  while (bucket < PB_GC_PAUSE_BUCKETS - 1 && pauseMs > bucketLimits[bucket]) {
+    bucket++;
+  }
+
+  stats->collections++;
+  stats->pauseHistogram[bucket]++;
+  stats->lastPauseMs = pauseMs;
+  stats->totalPauseMs += pauseMs;
+  if (pauseMs > stats->maxPauseMs) stats->maxPauseMs = pauseMs;
+  stats->liveBytes = vm.bytesAllocated;
+  stats->lastBytesFreed = before > vm.bytesAllocated ? before - vm.bytesAllocated : 0;
+  stats->totalBytesFreed += stats->lastBytesFreed;
+  stats->lastBytesMarked = marked;
+}
+
+// a stop-the-world pause grows with the heap it has to sweep, so when pauses
+// run over the target the heap is allowed to grow less before the next cycle,
+// and the factor drifts back up once pauses are comfortably under it
+static void adjustGrowthFactor(double pauseMs) {
+  double target = vm.config.gc.pauseTargetMs;
+  double configured = configuredGrowthFactor();
+  if (target <= 0) {
+    vm.gcGrowthFactor = configured;
+    return;
+  }
+
+  if (pauseMs > target) {
+    vm.gcGrowthFactor = 1.0 + (vm.gcGrowthFactor - 1.0) * 0.75;
+    if (vm.gcGrowthFactor < GC_MIN_GROW_FACTOR) vm.gcGrowthFactor = GC_MIN_GROW_FACTOR;
+  } else if (pauseMs < target / 2) {
+    vm.gcGrowthFactor = 1.0 + (vm.gcGrowthFactor - 1.0) * 1.25;
+    if (vm.gcGrowthFactor > configured) vm.gcGrowthFactor = configured;
+  }
+}
+
+static size_t nextThreshold(void) {
+  size_t next = (size_t)((double)vm.bytesAllocated * vm.gcGrowthFactor);
+  size_t minimum = vm.config.gc.minHeapSize > 0 ? vm.config.gc.minHeapSize
+                                                : GC_MIN_HEAP_SIZE;
+  if (next < minimum) next = minimum;
+
+  // past the cap there is nothing to gain from collecting on every allocation
+  size_t maximum = vm.config.gc.maxHeapSize;
+  if (maximum > 0 && next > maximum && maximum > vm.bytesAllocated) {
+    next = maximum;
+  }
+  return next;
+}
+
+void collectGarbage() {
+#ifdef DEBUG_LOG_GC
+  printf("--gc begin\n");
+#endif
+  size_t before = vm.bytesAllocated;
+  double start = monotonicMs();
+  vm.collecting = true;
+
+  markRoots();
+  traceReferences();
+  tableRemoveWhite(&vm.strings);
+  size_t marked = sweep();
+
+  vm.collecting = false;
+
+  double pauseMs = monotonicMs() - start;
+  recordPause(pauseMs, before, marked);
+  adjustGrowthFactor(pauseMs);
+  vm.nextGC = nextThreshold();
+
+#ifdef DEBUG_LOG_GC
+  printf("--gc end\n");
+  printf("   collected %zu bytes (from %zu to %zu) next at %zu\n",
+         before - vm.bytesAllocated, before, vm.bytesAllocated,
+         vm.nextGC);
+  #endif
+
+}
+
+// releases what the object owns and hands its slot back to the page
+static void freeObject(Obj* object) {
+#ifdef DEBUG_LOG_GC
+  printf("%p free type %d\n", (void*)object, object->type);
+#endif
+  vm.gcStats.liveObjects[object->type]--;
+
+  switch (object->type) {
     case OBJ_FUNCTION: {
-      ObjFunction* function = (ObjFunction*)object;
-      freeChunk(&function->chunk);
-      FREE(ObjFunction, object);
+      ObjFunction* function = (ObjFunction*)object;
+      freeChunk(&function->chunk);
       break;
     }
     case OBJ_CLOSURE: {
       ObjClosure* closure = (ObjClosure*)object;
       FREE_ARRAY(ObjUpvalue*, closure->upvalues, closure->upvalueCount);
-      FREE(ObjClosure, object);
       break;
     }
     case OBJ_UPVALUE:
-      FREE(ObjUpvalue, object);
-      break;
-    case OBJ_NATIVE:
-      FREE(ObjNative, object);
-      break;
-    case OBJ_STRING: {
-      ObjString* string = (ObjString*)object;
-      FREE_ARRAY(char, string->chars, string->length + 1);
-      FREE(ObjString, object);
-      break;
-    }
-    case OBJ_LIST: {
-      ObjList* list = (ObjList*)object;
-      FREE_ARRAY(Value, list->items.values, list->items.capacity);
-      FREE(ObjList, object);
-      break;
-    }
+      break;
+    case OBJ_NATIVE:
+      break;
+    case OBJ_STRING: {
+      ObjString* string = (ObjString*)object;
+      FREE_ARRAY(char, string->chars, string->length + 1);
+      break;
+    }
+    case OBJ_LIST:
+      freeList((ObjList*)object);
+      break;
     case OBJ_HASHMAP: {
       ObjHashmap* hashmap = (ObjHashmap*)object;
       freeMap(&hashmap->items);
-      FREE(ObjHashmap, object);
-      break;
-    }
-    case OBJ_CLASS: {
-      ObjClass* klass = (ObjClass*)object;
-      freeTable(&klass->methods);
-      FREE(ObjClass, object);
-      break;
-    }
-    case OBJ_INSTANCE: {
-      ObjInstance* instance = (ObjInstance*)object;
-      freeTable(&instance->fields);
-      FREE(ObjInstance, object);
-      break;
-    }
+      break;
+    }
+    case OBJ_CLASS: {
+      ObjClass* klass = (ObjClass*)object;
+      freeTable(&klass->methods);
+      break;
+    }
+    case OBJ_INSTANCE: {
+      ObjInstance* instance = (ObjInstance*)object;
+      freeTable(&instance->fields);
+      break;
+    }
     case OBJ_BOUND_METHOD: {
-      FREE(ObjBoundMethod, object);
       break;
     }
     case OBJ_MODULE: {
       ObjModule* module = (ObjModule*)object;
       freeTable(&module->globals);
       freeTable(&module->exports);
-      FREE(ObjModule, object);
       break;
     }
-  }
-}
-
-void freeObjects() {
-  Obj* object = vm.objects;
-  while (object != NULL) {
-    Obj* next = object->next;
-    freeObject(object);
-    object = next;
-  }
-
-  free(vm.grayStack);
-}
-
-static void markRoots() {
-  for (Value* slot = vm.stack; slot < vm.stackTop; slot++) {
-    markValue(*slot);
-  }
-
+    case OBJ_SET:
+      freeSet(&((ObjSet*)object)->items);
+      break;
+    case OBJ_PRIORITY_QUEUE:
+      freePriorityQueue(&((ObjPriorityQueue*)object)->items);
+      break;
+    case OBJ_FLOAT_ARRAY: {
+      ObjFloatArray* array = (ObjFloatArray*)object;
+      FREE_ARRAY(double, array->values, array->count);
+      break;
+    }
+    case OBJ_RANGE:
+    case OBJ_SEQUENCE:
+    case OBJ_BYTES:
+      break;
+    case OBJ_STRING_BUILDER:
+      freeStringBuilder(&((ObjStringBuilder*)object)->builder);
+      break;
+  }
+
+  object->type = OBJ_FREE;
+}
+
+static void releasePage(ObjPage* page) {
+  size_t bytes = pageBytes(page->slotSize);
+  vm.bytesAllocated -= bytes;
+  rawReallocate(page, bytes, 0);
+}
+
+void freeObjects() {
+  ObjPage* page = vm.pages;
+  while (page != NULL) {
+    ObjPage* next = page->next;
+    for (uint32_t i = 0; i < page->slotCount; i++) {
+      Obj* object = PAGE_SLOT(page, i);
+      if (object->type != OBJ_FREE) freeObject(object);
+    }
+    releasePage(page);
+    page = next;
+  }
+  vm.pages = NULL;
+  for (int i = 0; i < OBJ_SIZE_CLASSES; i++) vm.freeSlots[i] = NULL;
+  rawReallocate(vm.sparePage, OBJ_PAGE_SIZE, 0);
+  vm.sparePage = NULL;
+
+  rawReallocate(vm.grayStack, sizeof(Obj*) * vm.grayCapacity, 0);
+  vm.grayStack = NULL;
+  vm.grayCapacity = 0;
+}
+
+static void markRoots() {
+  for (Value* slot = vm.stack; slot < vm.stackTop; slot++) {
+    markValue(*slot);
+  }
+
   for (int i = 0; i < vm.frameCount; i++) {
     markObject((Obj*)vm.frames[i].closure);
   }
@@ -250,41 +640,79 @@ static void markRoots() {
        upvalue = upvalue->next) {
     markObject((Obj*)upvalue);
   }
-
+
   markTable(&vm.globals);
   markTable(&vm.prelude);
   markTable(&vm.modules);
   markCompilerRoots();
   markObject((Obj*)vm.initString);
+  markObject((Obj*)vm.emptyString);
+  for (int byte = 0; byte < 256; byte++) markObject((Obj*)vm.byteStrings[byte]);
   if (vm.hasLastReturnValue) markValue(vm.lastReturnValue);
 }
-
-static void traceReferences() {
-  while (vm.grayCount > 0) {
-    Obj* object = vm.grayStack[--vm.grayCount];
-    blackenObject(object);
-  }
-}
-
-static void sweep() {
-  Obj* previous = NULL;
-  Obj* object = vm.objects;
-  
-  while (object != NULL) {
-    if (object->isMarked) {
-      object->isMarked = false;
-      previous = object;
-      object = object->next;
-    } else {
-      Obj* unreached = object;
-      object = object->next;
-      if (previous != NULL) {
-        previous->next = object;
-      } else {
-        vm.objects = object;
-      }
-
-      freeObject(unreached);
-    }
-  }
+
+static void traceReferences() {
+  do {
+    while (vm.grayCount > 0) {
+      Obj* object = vm.grayStack[--vm.grayCount];
+      blackenObject(object);
+    }
+
+    // blackening is idempotent, so rescanning every marked object catches
+    // the ones markObject could not push
+    if (!vm.grayStackOverflow) break;
+    vm.grayStackOverflow = false;
+    for (ObjPage* page = vm.pages; page != NULL; page = page->next) {
+      for (uint32_t i = 0; i < page->slotCount; i++) {
+        Obj* object = PAGE_SLOT(page, i);
+        if (object->type != OBJ_FREE && object->isMarked) blackenObject(object);
+      }
+    }
+  } while (vm.grayCount > 0 || vm.grayStackOverflow);
+}
+
+// walks every page, freeing unmarked objects and rebuilding the free lists;
+// pages left without a live object go back to the allocator. Returns the
+// bytes the marked objects hold, slots included
+static size_t sweep() {
+  for (int i = 0; i < OBJ_SIZE_CLASSES; i++) vm.freeSlots[i] = NULL;
+  size_t marked = 0;
+
+  ObjPage** link = &vm.pages;
+  while (*link != NULL) {
+    ObjPage* page = *link;
+    FreeSlot* head = NULL;
+    FreeSlot* tail = NULL;
+    bool live = false;
+
+    for (uint32_t i = 0; i < page->slotCount; i++) {
+      Obj* object = PAGE_SLOT(page, i);
+      if (object->type != OBJ_FREE && object->isMarked) {
+        object->isMarked = false;
+        marked += page->slotSize + objectOwnedBytes(object);
+        live = true;
+        continue;
+      }
+      if (object->type != OBJ_FREE) freeObject(object);
+
+      FreeSlot* slot = (FreeSlot*)object;
+      slot->next = head;
+      head = slot;
+      if (tail == NULL) tail = slot;
+    }
+
+    if (!live) {
+      *link = page->next;
+      releasePage(page);
+      continue;
+    }
+
+    size_t sizeClass = page->slotSize / 8;
+    if (head != NULL && sizeClass < OBJ_SIZE_CLASSES) {
+      tail->next = vm.freeSlots[sizeClass];
+      vm.freeSlots[sizeClass] = head;
+    }
+    link = &page->next;
+  }
+  return marked;
 }
@@ -5,9 +5,13 @@
 #include <math.h>
 #include <limits.h>
 
+#include "headers/float_array.h"
 #include "headers/native.h"
 #include "headers/memory.h"
 #include "headers/object.h"
+#include "headers/range.h"
+#include "headers/search.h"
+#include "headers/sort.h"
 #include "headers/vm.h"
 
 Value clockNative(int argCount, Value *args)
@@ -79,62 +83,115 @@ Value strInputNative(int argCount, Value *args)
     return OBJ_VAL(copyString(buffer, strlen(buffer)));
 }
 
-int Valuecomp(const void *elem1, const void *elem2)
+static bool isCallable(Value value)
 {
-    Value f = *((Value *)elem1);
-    Value s = *((Value *)elem2);
+    return IS_CLOSURE(value) || IS_NATIVE(value) || IS_BOUND_METHOD(value) ||
+           IS_CLASS(value);
+}
 
-    if (IS_NUMBER(f) && IS_NUMBER(s))
-    {
-        double df = AS_NUMBER(f);
-        double ds = AS_NUMBER(s);
-        if (df > ds)
-            return 1;
-        if (ds > df)
-            return -1;
-        return 0;
-    }
-    else if (IS_STRING(f) && IS_STRING(s))
-    {
-        ObjString *strF = AS_STRING(f);
-        ObjString *strS = AS_STRING(s);
-        return strcmp(strF->chars, strS->chars);
+// the value kind sort() can order a run of values by, or VAL_NIL with a
+// runtime error reported when there is none
+static ValueType sortableType(Value *values, int count, const char *what)
+{
+    ValueType elementType = values[0].type;
+    if (elementType != VAL_NUMBER &&
+        !(elementType == VAL_OBJ && IS_STRING(values[0]))) {
+        runtimeError("sort() only supports %s of numbers or strings.", what);
+        return VAL_NIL;
     }
-    else
-    {
-        return 0;
+
+    for (int i = 1; i < count; i++) {
+        if (values[i].type != elementType ||
+            (elementType == VAL_OBJ && !IS_STRING(values[i]))) {
+            runtimeError("sort() requires %s of one supported type.", what);
+            return VAL_NIL;
+        }
+    }
+    return elementType;
+}
+
+// Keys are computed once per element through a call back into the script,
+// then the engine sorts their indices and the list is permuted to match, so
+// the key function runs n times rather than once per comparison.
+static bool sortByKeys(ObjList *list, Value key, bool descending)
+{
+    int count = list->items.count;
+    ObjList *keys = newList();
+    push(OBJ_VAL(keys));
+    if (!listReserve(keys, count)) return false;
+
+    if (IS_NIL(key)) {
+        memcpy(keys->items.values, list->items.values, sizeof(Value) * (size_t)count);
+        keys->items.count = count;
+    }
+    for (int i = 0; keys->items.count < count; i++) {
+        Value element = list->items.values[i];
+        Value elementKey;
+        if (!callFromNative(key, 1, &element, &elementKey)) return false;
+        if (list->items.count != count) {
+            runtimeError("List was modified during sort().");
+            return false;
+        }
+        listAppend(keys, elementKey);
     }
+
+    if (sortableType(keys->items.values, count,
+                     IS_NIL(key) ? "lists" : "keys") == VAL_NIL) {
+        return false;
+    }
+
+    int *order = ALLOCATE(int, count);
+    if (order == NULL) return false;
+    if (!sortOrder(keys->items.values, count, descending, order)) {
+        FREE_ARRAY(int, order, count);
+        return false;
+    }
+
+    // the keys list is finished with, so its storage holds the old order
+    memcpy(keys->items.values, list->items.values, sizeof(Value) * (size_t)count);
+    for (int i = 0; i < count; i++) {
+        list->items.values[i] = keys->items.values[order[i]];
+    }
+
+    FREE_ARRAY(int, order, count);
+    pop();
+    return true;
 }
 
 Value listSortNative(int argCount, Value *args)
 {
-    if (argCount != 1 || !IS_LIST(args[0])) {
-        runtimeError("sort() expects a list and no arguments.");
+    if (argCount < 1 || argCount > 3 || !IS_LIST(args[0])) {
+        runtimeError("sort() expects an optional key function and reverse flag.");
+        return NIL_VAL;
+    }
+
+    Value key = argCount >= 2 ? args[1] : NIL_VAL;
+    if (!IS_NIL(key) && !isCallable(key)) {
+        runtimeError("sort() key must be a function or nil.");
+        return NIL_VAL;
+    }
+    if (argCount == 3 && !IS_BOOL(args[2])) {
+        runtimeError("sort() reverse flag must be a boolean.");
         return NIL_VAL;
     }
+    bool descending = argCount == 3 && AS_BOOL(args[2]);
 
     ObjList *list = AS_LIST(args[0]);
     if (list->items.count < 2) {
         return NIL_VAL;
     }
 
-    ValueType elementType = list->items.values[0].type;
-    if (elementType != VAL_NUMBER &&
-        !(elementType == VAL_OBJ && IS_STRING(list->items.values[0]))) {
-        runtimeError("sort() only supports lists of numbers or strings.");
+    if (!IS_NIL(key) || descending) {
+        sortByKeys(list, key, descending);
         return NIL_VAL;
     }
 
-    for (int i = 1; i < list->items.count; i++) {
-        Value element = list->items.values[i];
-        if (element.type != elementType ||
-            (elementType == VAL_OBJ && !IS_STRING(element))) {
-            runtimeError("sort() requires values of one supported type.");
-            return NIL_VAL;
-        }
+    ValueType elementType = sortableType(list->items.values, list->items.count, "lists");
+    if (elementType == VAL_NUMBER) {
+        sortNumbers(list->items.values, list->items.count);
+    } else if (elementType != VAL_NIL) {
+        sortStrings(list->items.values, list->items.count);
     }
-
-    qsort(list->items.values, list->items.count, sizeof(Value), Valuecomp);
     return NIL_VAL;
 }
 
@@ -146,8 +203,7 @@ Value listPushNative(int argCount, Value *args)
         return NIL_VAL;
     }
 
-    ObjList *list = AS_LIST(args[0]);
-    writeValueArray(&list->items, args[1]);
+    listAppend(AS_LIST(args[0]), args[1]);
 
     return NIL_VAL;
 }
@@ -216,8 +272,9 @@ Value listExtendNative(int argCount, Value *args)
     ObjList *other = AS_LIST(args[1]);
     int otherCount = other->items.count;
 
+    listReserve(list, list->items.count + otherCount);
     for (int i = 0; i < otherCount; i++) {
-        writeValueArray(&list->items, other->items.values[i]);
+        listAppend(list, other->items.values[i]);
     }
 
     return NIL_VAL;
@@ -242,13 +299,7 @@ Value listPopNative(int argCount, Value *args)
         return NIL_VAL;
     }
 
-    Value value = list->items.values[index];
-    memmove(&list->items.values[index],
-            &list->items.values[index + 1],
-            sizeof(Value) * (list->items.count - index - 1));
-    list->items.count--;
-
-    return value;
+    return listRemoveAt(list, index);
 }
 
 Value listInsertNative(int argCount, Value *args)
@@ -264,12 +315,7 @@ Value listInsertNative(int argCount, Value *args)
         return NIL_VAL;
     }
 
-    int oldCount = list->items.count;
-    writeValueArray(&list->items, NIL_VAL);
-    memmove(&list->items.values[index + 1],
-            &list->items.values[index],
-            sizeof(Value) * (oldCount - index));
-    list->items.values[index] = args[2];
+    listInsertAt(list, index, args[2]);
 
     return NIL_VAL;
 }
@@ -282,20 +328,14 @@ Value listRemoveNative(int argCount, Value *args)
     }
 
     ObjList *list = AS_LIST(args[0]);
-    for (int i = 0; i < list->items.count; i++) {
-        if (!valuesEqual(list->items.values[i], args[1])) {
-            if (vm.hadRuntimeError) return NIL_VAL;
-            continue;
-        }
-
-        memmove(&list->items.values[i],
-                &list->items.values[i + 1],
-                sizeof(Value) * (list->items.count - i - 1));
-        list->items.count--;
+    int index = findValue(list->items.values, list->items.count, args[1]);
+    if (vm.hadRuntimeError) return NIL_VAL;
+    if (index == -1) {
+        runtimeError("List value not found.");
         return NIL_VAL;
     }
 
-    runtimeError("List value not found.");
+    listRemoveAt(list, index);
     return NIL_VAL;
 }
 
@@ -312,13 +352,7 @@ Value listRemoveAtNative(int argCount, Value *args)
         return NIL_VAL;
     }
 
-    Value value = list->items.values[index];
-    memmove(&list->items.values[index],
-            &list->items.values[index + 1],
-            sizeof(Value) * (list->items.count - index - 1));
-    list->items.count--;
-
-    return value;
+    return listRemoveAt(list, index);
 }
 
 Value listClearNative(int argCount, Value *args)
@@ -328,7 +362,7 @@ Value listClearNative(int argCount, Value *args)
         return NIL_VAL;
     }
 
-    AS_LIST(args[0])->items.count = 0;
+    listClear(AS_LIST(args[0]));
     return NIL_VAL;
 }
 
@@ -344,8 +378,9 @@ Value listCopyNative(int argCount, Value *args)
 
     // Keep the new list reachable if growing its backing array triggers GC.
     push(OBJ_VAL(copy));
+    listReserve(copy, source->items.count);
     for (int i = 0; i < source->items.count; i++) {
-        writeValueArray(&copy->items, source->items.values[i]);
+        listAppend(copy, source->items.values[i]);
     }
     return pop();
 }
@@ -358,15 +393,14 @@ Value listIndexNative(int argCount, Value *args)
     }
 
     ObjList *list = AS_LIST(args[0]);
-    for (int i = 0; i < list->items.count; i++) {
-        if (valuesEqual(list->items.values[i], args[1])) {
-            return NUMBER_VAL(i);
-        }
-        if (vm.hadRuntimeError) return NIL_VAL;
+    int index = findValue(list->items.values, list->items.count, args[1]);
+    if (vm.hadRuntimeError) return NIL_VAL;
+    if (index == -1) {
+        runtimeError("List value not found.");
+        return NIL_VAL;
     }
 
-    runtimeError("List value not found.");
-    return NIL_VAL;
+    return NUMBER_VAL(index);
 }
 
 Value listCountNative(int argCount, Value *args)
@@ -377,13 +411,8 @@ Value listCountNative(int argCount, Value *args)
     }
 
     ObjList *list = AS_LIST(args[0]);
-    int count = 0;
-    for (int i = 0; i < list->items.count; i++) {
-        if (valuesEqual(list->items.values[i], args[1])) {
-            count++;
-        }
-        if (vm.hadRuntimeError) return NIL_VAL;
-    }
+    int count = countValue(list->items.values, list->items.count, args[1]);
+    if (vm.hadRuntimeError) return NIL_VAL;
 
     return NUMBER_VAL(count);
 }
@@ -406,6 +435,192 @@ Value listReverseNative(int argCount, Value *args)
     return NIL_VAL;
 }
 
+// a capacity for reserve(): anything a script could plausibly fill, capped
+// well short of the int overflow in the growth arithmetic
+#define MAX_RESERVE (1 << 26)
+
+static bool reserveCount(Value countValue, int *outCount)
+{
+    if (!IS_NUMBER(countValue)) {
+        runtimeError("reserve() expects a number.");
+        return false;
+    }
+
+    double count = AS_NUMBER(countValue);
+    if (!isfinite(count) || floor(count) != count || count < 0) {
+        runtimeError("reserve() expects a non-negative integer.");
+        return false;
+    }
+    if (count > MAX_RESERVE) {
+        runtimeError("reserve() capacity is too large.");
+        return false;
+    }
+
+    *outCount = (int)count;
+    return true;
+}
+
+Value listReserveNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_LIST(args[0])) {
+        runtimeError("reserve() expects a list and a capacity.");
+        return NIL_VAL;
+    }
+
+    int count;
+    if (!reserveCount(args[1], &count)) return NIL_VAL;
+
+    listReserve(AS_LIST(args[0]), count);
+    return NIL_VAL;
+}
+
+Value listShrinkToFitNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_LIST(args[0])) {
+        runtimeError("shrinkToFit() expects a list.");
+        return NIL_VAL;
+    }
+
+    listShrinkToFit(AS_LIST(args[0]));
+    return NIL_VAL;
+}
+
+// Checks the receiver and function of a higher-order list method and
+// prepares the function to be called with callbackArity arguments.
+static bool prepareListCallback(const char *method, int argCount, Value *args,
+                                int callbackArity, NativeCallback *callback)
+{
+    if (argCount != 2 || !IS_LIST(args[0]) || !isCallable(args[1])) {
+        runtimeError("%s() expects a function.", method);
+        return false;
+    }
+    return prepareCallback(callback, args[1], callbackArity);
+}
+
+// The element loops below read the count afresh on every step, so a function
+// that pushes to or pops from the list it is walking never reads past its end.
+
+Value listMapNative(int argCount, Value *args)
+{
+    NativeCallback callback;
+    if (!prepareListCallback("map", argCount, args, 1, &callback)) return NIL_VAL;
+
+    ObjList *list = AS_LIST(args[0]);
+    ObjList *result = newList();
+    push(OBJ_VAL(result));
+    listReserve(result, list->items.count);
+
+    for (int i = 0; i < list->items.count; i++) {
+        Value mapped;
+        if (!invokeCallback(&callback, &list->items.values[i], &mapped)) return NIL_VAL;
+        // only a function that grows the list can make this append allocate
+        push(mapped);
+        listAppend(result, mapped);
+        pop();
+    }
+
+    pop();
+    return OBJ_VAL(result);
+}
+
+Value listFilterNative(int argCount, Value *args)
+{
+    NativeCallback callback;
+    if (!prepareListCallback("filter", argCount, args, 1, &callback)) return NIL_VAL;
+
+    ObjList *list = AS_LIST(args[0]);
+    ObjList *result = newList();
+    push(OBJ_VAL(result));
+    listReserve(result, list->items.count);
+
+    for (int i = 0; i < list->items.count; i++) {
+        Value element = list->items.values[i];
+        Value keep;
+        if (!invokeCallback(&callback, &element, &keep)) return NIL_VAL;
+        if (isFalsey(keep)) continue;
+        push(element);
+        listAppend(result, element);
+        pop();
+    }
+
+    // the result was sized for every element passing
+    if (result->items.count < result->items.capacity / 2) listShrinkToFit(result);
+    pop();
+    return OBJ_VAL(result);
+}
+
+Value listReduceNative(int argCount, Value *args)
+{
+    if (argCount < 2 || argCount > 3 || !IS_LIST(args[0]) || !isCallable(args[1])) {
+        runtimeError("reduce() expects a function and an optional initial value.");
+        return NIL_VAL;
+    }
+
+    NativeCallback callback;
+    if (!prepareCallback(&callback, args[1], 2)) return NIL_VAL;
+
+    ObjList *list = AS_LIST(args[0]);
+    int start = 0;
+    Value pair[2];
+    if (argCount == 3) {
+        pair[0] = args[2];
+    } else if (list->items.count == 0) {
+        runtimeError("Cannot reduce an empty list without an initial value.");
+        return NIL_VAL;
+    } else {
+        pair[0] = list->items.values[0];
+        start = 1;
+    }
+
+    // the accumulator lives in pair between calls, out of the collector's
+    // sight, so it rides in the callback's argument slots
+    for (int i = start; i < list->items.count; i++) {
+        pair[1] = list->items.values[i];
+        if (!invokeCallback(&callback, pair, &pair[0])) return NIL_VAL;
+    }
+
+    return pair[0];
+}
+
+Value listForEachNative(int argCount, Value *args)
+{
+    NativeCallback callback;
+    if (!prepareListCallback("forEach", argCount, args, 1, &callback)) return NIL_VAL;
+
+    ObjList *list = AS_LIST(args[0]);
+    for (int i = 0; i < list->items.count; i++) {
+        Value ignored;
+        if (!invokeCallback(&callback, &list->items.values[i], &ignored)) return NIL_VAL;
+    }
+    return NIL_VAL;
+}
+
+// any() and all() stop at the first element that settles the answer
+static Value listTestElements(const char *method, int argCount, Value *args,
+                              bool stopWhen)
+{
+    NativeCallback callback;
+    if (!prepareListCallback(method, argCount, args, 1, &callback)) return NIL_VAL;
+
+    ObjList *list = AS_LIST(args[0]);
+    for (int i = 0; i < list->items.count; i++) {
+        Value passed;
+        if (!invokeCallback(&callback, &list->items.values[i], &passed)) return NIL_VAL;
+        if (!isFalsey(passed) == stopWhen) return BOOL_VAL(stopWhen);
+    }
+    return BOOL_VAL(!stopWhen);
+}
+
+Value listAnyNative(int argCount, Value *args)
+{
+    return listTestElements("any", argCount, args, true);
+}
+
+Value listAllNative(int argCount, Value *args)
+{
+    return listTestElements("all", argCount, args, false);
+}
+
 Value mapHasNative(int argCount, Value *args)
 {
     if (argCount != 2 || !IS_HASHMAP(args[0])) {
@@ -464,18 +679,868 @@ Value mapClearNative(int argCount, Value *args)
     return NIL_VAL;
 }
 
-Value lenNative(int argCount, Value *args)
+Value mapReserveNative(int argCount, Value *args)
 {
-    if (argCount != 1) {
-        runtimeError("len() expects one value.");
+    if (argCount != 2 || !IS_HASHMAP(args[0])) {
+        runtimeError("reserve() expects a map and a capacity.");
         return NIL_VAL;
     }
 
-    if (IS_STRING(args[0])) return NUMBER_VAL(AS_STRING(args[0])->length);
-    if (IS_LIST(args[0])) return NUMBER_VAL(AS_LIST(args[0])->items.count);
-    if (IS_HASHMAP(args[0])) return NUMBER_VAL(mapCount(&AS_HASHMAP(args[0])->items));
+    int count;
+    if (!reserveCount(args[1], &count)) return NIL_VAL;
+
+    mapReserve(&AS_HASHMAP(args[0])->items, count);
+    return NIL_VAL;
+}
+
+Value mapShrinkToFitNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_HASHMAP(args[0])) {
+        runtimeError("shrinkToFit() expects a map.");
+        return NIL_VAL;
+    }
+
+    mapShrinkToFit(&AS_HASHMAP(args[0])->items);
+    return NIL_VAL;
+}
+
+static bool setElement(Value element)
+{
+    if (!mapKeyIsValid(element)) {
+        runtimeError("Set elements must be nil, booleans, finite numbers, or strings.");
+        return false;
+    }
+    return true;
+}
+
+Value setNative(int argCount, Value *args)
+{
+    if (argCount > 1 || (argCount == 1 && !IS_LIST(args[0]))) {
+        runtimeError("Set() expects nothing or a list of elements.");
+        return NIL_VAL;
+    }
+
+    ObjSet *set = newSet();
+    if (argCount == 0) return OBJ_VAL(set);
+
+    push(OBJ_VAL(set));
+    ObjList *elements = AS_LIST(args[0]);
+    for (int i = 0; i < elements->items.count; i++) {
+        if (!setElement(elements->items.values[i])) {
+            pop();
+            return NIL_VAL;
+        }
+        setAdd(&set->items, elements->items.values[i]);
+    }
+    pop();
+    return OBJ_VAL(set);
+}
+
+Value setAddNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_SET(args[0])) {
+        runtimeError("add() expects a set and an element.");
+        return NIL_VAL;
+    }
+    if (!setElement(args[1])) return NIL_VAL;
+
+    return BOOL_VAL(setAdd(&AS_SET(args[0])->items, args[1]));
+}
+
+Value setHasNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_SET(args[0])) {
+        runtimeError("has() expects a set and an element.");
+        return NIL_VAL;
+    }
+    if (!setElement(args[1])) return NIL_VAL;
+
+    return BOOL_VAL(setHas(&AS_SET(args[0])->items, args[1]));
+}
+
+Value setDeleteNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_SET(args[0])) {
+        runtimeError("delete() expects a set and an element.");
+        return NIL_VAL;
+    }
+    if (!setElement(args[1])) return NIL_VAL;
+
+    return BOOL_VAL(setDelete(&AS_SET(args[0])->items, args[1]));
+}
+
+Value setClearNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_SET(args[0])) {
+        runtimeError("clear() expects a set.");
+        return NIL_VAL;
+    }
+
+    freeSet(&AS_SET(args[0])->items);
+    return NIL_VAL;
+}
+
+typedef enum {
+    SET_UNION,
+    SET_INTERSECTION,
+    SET_DIFFERENCE,
+} SetOperation;
+
+// a new set holding the receiver's elements that the operation keeps,
+// followed for a union by the other set's new ones
+static Value combineSets(int argCount, Value *args, const char *name,
+                         SetOperation operation)
+{
+    if (argCount != 2 || !IS_SET(args[0]) || !IS_SET(args[1])) {
+        runtimeError("%s() expects two sets.", name);
+        return NIL_VAL;
+    }
+
+    Set *left = &AS_SET(args[0])->items;
+    Set *right = &AS_SET(args[1])->items;
+    ObjSet *result = newSet();
+    push(OBJ_VAL(result));
+
+    for (int position = setNextKey(left, -1); position != -1;
+         position = setNextKey(left, position)) {
+        Value key = SET_KEY_AT(left, position);
+        bool keep = operation == SET_UNION ||
+                    setHas(right, key) == (operation == SET_INTERSECTION);
+        if (keep) setAdd(&result->items, key);
+    }
+    if (operation == SET_UNION) {
+        for (int position = setNextKey(right, -1); position != -1;
+             position = setNextKey(right, position)) {
+            setAdd(&result->items, SET_KEY_AT(right, position));
+        }
+    }
+
+    pop();
+    return OBJ_VAL(result);
+}
+
+Value setUnionNative(int argCount, Value *args)
+{
+    return combineSets(argCount, args, "union", SET_UNION);
+}
+
+Value setIntersectionNative(int argCount, Value *args)
+{
+    return combineSets(argCount, args, "intersection", SET_INTERSECTION);
+}
+
+Value setDifferenceNative(int argCount, Value *args)
+{
+    return combineSets(argCount, args, "difference", SET_DIFFERENCE);
+}
+
+Value setValuesNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_SET(args[0])) {
+        runtimeError("values() expects a set.");
+        return NIL_VAL;
+    }
+
+    Set *set = &AS_SET(args[0])->items;
+    ObjList *list = newList();
+    push(OBJ_VAL(list));
+    listReserve(list, setCount(set));
+    for (int position = setNextKey(set, -1); position != -1;
+         position = setNextKey(set, position)) {
+        listAppend(list, SET_KEY_AT(set, position));
+    }
+    pop();
+    return OBJ_VAL(list);
+}
+
+Value priorityQueueNative(int argCount, Value *args)
+{
+    if (argCount > 1 || (argCount == 1 && !isCallable(args[0]))) {
+        runtimeError("PriorityQueue() expects nothing or a key function.");
+        return NIL_VAL;
+    }
+
+    return OBJ_VAL(newPriorityQueue(argCount == 1 ? args[0] : NIL_VAL));
+}
+
+Value priorityQueuePushNative(int argCount, Value *args)
+{
+    if ((argCount != 2 && argCount != 3) || !IS_PRIORITY_QUEUE(args[0])) {
+        runtimeError("push() expects a priority queue, an item, and an optional priority.");
+        return NIL_VAL;
+    }
+
+    ObjPriorityQueue *queue = AS_PRIORITY_QUEUE(args[0]);
+    Value priority = argCount == 3 ? args[2] : args[1];
+    if (argCount == 2 && !IS_NIL(queue->key) &&
+        !callFromNative(queue->key, 1, &args[1], &priority)) {
+        return NIL_VAL;
+    }
+
+    if (!priorityQueueAccepts(&queue->items, priority)) {
+        runtimeError("Priorities must be all numbers or all strings.");
+        return NIL_VAL;
+    }
+
+    // a computed priority is not on the stack yet
+    push(priority);
+    priorityQueuePush(&queue->items, priority, args[1]);
+    pop();
+    return NIL_VAL;
+}
+
+Value priorityQueuePopNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_PRIORITY_QUEUE(args[0])) {
+        runtimeError("pop() expects a priority queue.");
+        return NIL_VAL;
+    }
+
+    PriorityQueue *queue = &AS_PRIORITY_QUEUE(args[0])->items;
+    if (queue->count == 0) {
+        runtimeError("Cannot pop from an empty priority queue.");
+        return NIL_VAL;
+    }
+
+    return priorityQueuePop(queue);
+}
+
+Value priorityQueuePeekNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_PRIORITY_QUEUE(args[0])) {
+        runtimeError("peek() expects a priority queue.");
+        return NIL_VAL;
+    }
+
+    PriorityQueue *queue = &AS_PRIORITY_QUEUE(args[0])->items;
+    if (queue->count == 0) {
+        runtimeError("Cannot peek at an empty priority queue.");
+        return NIL_VAL;
+    }
+
+    return PRIORITY_QUEUE_PEEK(queue);
+}
+
+// float arrays are sized up front, so their length gets the same cap as reserve()
+Value floatArrayNative(int argCount, Value *args)
+{
+    if (argCount != 1 || (!IS_NUMBER(args[0]) && !IS_LIST(args[0]))) {
+        runtimeError("FloatArray() expects a length or a list of numbers.");
+        return NIL_VAL;
+    }
+
+    if (IS_NUMBER(args[0])) {
+        double count = AS_NUMBER(args[0]);
+        if (!isfinite(count) || floor(count) != count || count < 0 ||
+            count > MAX_RESERVE) {
+            runtimeError("FloatArray() length must be a non-negative integer no larger than %d.",
+                         MAX_RESERVE);
+            return NIL_VAL;
+        }
+        return OBJ_VAL(newFloatArray((int)count));
+    }
+
+    ObjList *list = AS_LIST(args[0]);
+    for (int i = 0; i < list->items.count; i++) {
+        if (!IS_NUMBER(list->items.values[i])) {
+            runtimeError("Float array elements must be numbers.");
+            return NIL_VAL;
+        }
+    }
+
+    ObjFloatArray *array = newFloatArray(list->items.count);
+    for (int i = 0; i < array->count; i++) {
+        array->values[i] = AS_NUMBER(list->items.values[i]);
+    }
+    return OBJ_VAL(array);
+}
+
+Value floatArrayFillNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_FLOAT_ARRAY(args[0]) || !IS_NUMBER(args[1])) {
+        runtimeError("fill() expects a float array and a number.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    floatArrayFill(array->values, array->count, AS_NUMBER(args[1]));
+    return NIL_VAL;
+}
+
+Value floatArrayScaleNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_FLOAT_ARRAY(args[0]) || !IS_NUMBER(args[1])) {
+        runtimeError("scale() expects a float array and a number.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    floatArrayScale(array->values, array->count, AS_NUMBER(args[1]));
+    return NIL_VAL;
+}
+
+// adds a number to every element, or another array of the same length
+// element by element
+Value floatArrayAddNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_FLOAT_ARRAY(args[0]) ||
+        (!IS_NUMBER(args[1]) && !IS_FLOAT_ARRAY(args[1]))) {
+        runtimeError("add() expects a float array and a number or float array.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    if (IS_NUMBER(args[1])) {
+        floatArrayAddScalar(array->values, array->count, AS_NUMBER(args[1]));
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *other = AS_FLOAT_ARRAY(args[1]);
+    if (other->count != array->count) {
+        runtimeError("add() expects float arrays of the same length.");
+        return NIL_VAL;
+    }
+    floatArrayAdd(array->values, other->values, array->count);
+    return NIL_VAL;
+}
+
+Value floatArraySumNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_FLOAT_ARRAY(args[0])) {
+        runtimeError("sum() expects a float array.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    return NUMBER_VAL(floatArraySum(array->values, array->count));
+}
+
+Value floatArrayMinNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_FLOAT_ARRAY(args[0])) {
+        runtimeError("min() expects a float array.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    if (array->count == 0) {
+        runtimeError("Cannot take the minimum of an empty float array.");
+        return NIL_VAL;
+    }
+    return NUMBER_VAL(floatArrayMin(array->values, array->count));
+}
+
+Value floatArrayMaxNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_FLOAT_ARRAY(args[0])) {
+        runtimeError("max() expects a float array.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    if (array->count == 0) {
+        runtimeError("Cannot take the maximum of an empty float array.");
+        return NIL_VAL;
+    }
+    return NUMBER_VAL(floatArrayMax(array->values, array->count));
+}
+
+Value floatArrayToListNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_FLOAT_ARRAY(args[0])) {
+        runtimeError("toList() expects a float array.");
+        return NIL_VAL;
+    }
+
+    ObjFloatArray *array = AS_FLOAT_ARRAY(args[0]);
+    ObjList *list = newList();
+    push(OBJ_VAL(list));
+    if (!listReserve(list, array->count)) return NIL_VAL;
+    for (int i = 0; i < array->count; i++) {
+        list->items.values[i] = NUMBER_VAL(array->values[i]);
+    }
+    list->items.count = array->count;
+    pop();
+    return OBJ_VAL(list);
+}
+
+Value rangeNative(int argCount, Value *args)
+{
+    double start, end, step;
+    if (!rangeArguments(argCount, args, &start, &end, &step)) return NIL_VAL;
+    return OBJ_VAL(newRange(start, end, step));
+}
+
+static bool isSequence(Value value)
+{
+    return IS_RANGE(value) || IS_SEQUENCE(value);
+}
+
+static Value addSequenceStage(const char *method, SequenceKind kind, int argCount,
+                              Value *args)
+{
+    if (argCount != 2 || !isSequence(args[0]) || !isCallable(args[1])) {
+        runtimeError("%s() expects a function.", method);
+        return NIL_VAL;
+    }
+
+    // the function only runs once the sequence is iterated, but a wrong
+    // arity is reported here, where the pipeline is built
+    NativeCallback callback;
+    if (!prepareCallback(&callback, args[1], 1)) return NIL_VAL;
+    return OBJ_VAL(newSequence(kind, args[0], args[1]));
+}
+
+Value sequenceMapNative(int argCount, Value *args)
+{
+    return addSequenceStage("map", SEQUENCE_MAP, argCount, args);
+}
+
+Value sequenceFilterNative(int argCount, Value *args)
+{
+    return addSequenceStage("filter", SEQUENCE_FILTER, argCount, args);
+}
+
+Value sequenceReduceNative(int argCount, Value *args)
+{
+    if (argCount != 3 || !isSequence(args[0]) || !isCallable(args[1])) {
+        runtimeError("reduce() expects a function and an initial value.");
+        return NIL_VAL;
+    }
+
+    NativeCallback callback;
+    if (!prepareCallback(&callback, args[1], 2)) return NIL_VAL;
+
+    // the accumulator is kept in its argument slot, where the collector
+    // sees it while the sequence's own stages run
+    double position = 0;
+    Value pair[2];
+    Value *accumulator = &args[2];
+    while (sequenceNext(args[0], &position, &pair[1])) {
+        pair[0] = *accumulator;
+        if (!invokeCallback(&callback, pair, accumulator)) return NIL_VAL;
+    }
+    return vm.hadRuntimeError ? NIL_VAL : *accumulator;
+}
+
+Value sequenceToListNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !isSequence(args[0])) {
+        runtimeError("toList() expects a range or sequence.");
+        return NIL_VAL;
+    }
+
+    ObjList *list = newList();
+    push(OBJ_VAL(list));
+    if (IS_RANGE(args[0])) {
+        double count = rangeCount(AS_RANGE(args[0]));
+        if (count > MAX_RESERVE) {
+            runtimeError("Range is too long to make into a list.");
+            return NIL_VAL;
+        }
+        if (!listReserve(list, (int)count)) return NIL_VAL;
+    }
+
+    double position = 0;
+    Value element;
+    while (sequenceNext(args[0], &position, &element)) {
+        push(element);
+        bool appended = listAppend(list, element);
+        pop();
+        if (!appended) return NIL_VAL;
+    }
+    if (vm.hadRuntimeError) return NIL_VAL;
+
+    pop();
+    return OBJ_VAL(list);
+}
+
+Value stringBuilderNative(int argCount, Value *args)
+{
+    (void)args;
+    if (argCount != 0) {
+        runtimeError("StringBuilder() expects no arguments.");
+        return NIL_VAL;
+    }
+    return OBJ_VAL(newStringBuilder());
+}
+
+// appends in place and returns the builder, so appends can be chained;
+// growing the buffer may collect, but both arguments are on the stack
+Value stringBuilderAppendNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_STRING_BUILDER(args[0])) {
+        runtimeError("append() expects a string builder and a value.");
+        return NIL_VAL;
+    }
+
+    appendValue(&AS_STRING_BUILDER(args[0])->builder, args[1]);
+    return args[0];
+}
+
+Value stringBuilderAppendLineNative(int argCount, Value *args)
+{
+    if ((argCount != 1 && argCount != 2) || !IS_STRING_BUILDER(args[0])) {
+        runtimeError("appendLine() expects a string builder and an optional value.");
+        return NIL_VAL;
+    }
+
+    StringBuilder *builder = &AS_STRING_BUILDER(args[0])->builder;
+    if (argCount == 2) appendValue(builder, args[1]);
+    appendChars(builder, "\n", 1);
+    return args[0];
+}
+
+Value stringBuilderLenNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING_BUILDER(args[0])) {
+        runtimeError("len() expects a string builder.");
+        return NIL_VAL;
+    }
+    return NUMBER_VAL(AS_STRING_BUILDER(args[0])->builder.count);
+}
+
+// keeps the buffer, so a cleared builder refills without growing again
+Value stringBuilderClearNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING_BUILDER(args[0])) {
+        runtimeError("clear() expects a string builder.");
+        return NIL_VAL;
+    }
+
+    StringBuilder *builder = &AS_STRING_BUILDER(args[0])->builder;
+    builder->count = 0;
+    if (builder->chars != NULL) builder->chars[0] = '\0';
+    return NIL_VAL;
+}
+
+Value stringBuilderBuildNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING_BUILDER(args[0])) {
+        runtimeError("build() expects a string builder.");
+        return NIL_VAL;
+    }
+
+    StringBuilder *builder = &AS_STRING_BUILDER(args[0])->builder;
+    if (builder->count == 0) return OBJ_VAL(copyString("", 0));
+    return OBJ_VAL(copyString(builder->chars, builder->count));
+}
+
+// the separator and pattern arguments of split() and replace(), which have to
+// make progress through the text and so may not be empty
+static ObjString *patternArgument(Value value, const char *method)
+{
+    if (!IS_STRING(value)) {
+        runtimeError("%s() expects a string to search for.", method);
+        return NULL;
+    }
+    if (AS_STRING(value)->length == 0) {
+        runtimeError("%s() cannot search for an empty string.", method);
+        return NULL;
+    }
+    return AS_STRING(value);
+}
+
+static int countOccurrences(ObjString *string, ObjString *pattern)
+{
+    int count = 0;
+    for (int at = findBytes(string->chars, string->length, pattern->chars, pattern->length, 0);
+         at != -1;
+         at = findBytes(string->chars, string->length, pattern->chars, pattern->length,
+                        at + pattern->length)) {
+        count++;
+    }
+    return count;
+}
+
+Value stringFindNative(int argCount, Value *args)
+{
+    if ((argCount != 2 && argCount != 3) || !IS_STRING(args[0]) || !IS_STRING(args[1]) ||
+        (argCount == 3 && !IS_NUMBER(args[2]))) {
+        runtimeError("find() expects a string to search for and an optional start index.");
+        return NIL_VAL;
+    }
+
+    ObjString *string = AS_STRING(args[0]);
+    ObjString *needle = AS_STRING(args[1]);
+    int start = 0;
+    if (argCount == 3) {
+        double index = AS_NUMBER(args[2]);
+        if (!isfinite(index) || floor(index) != index || index < 0 ||
+            index > string->length) {
+            runtimeError("find() start index out of bounds.");
+            return NIL_VAL;
+        }
+        start = (int)index;
+    }
+
+    return NUMBER_VAL(findBytes(string->chars, string->length, needle->chars,
+                                needle->length, start));
+}
+
+// counts the pieces first, so the list is allocated once at its final size
+Value stringSplitNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_STRING(args[0])) {
+        runtimeError("split() expects a separator.");
+        return NIL_VAL;
+    }
+    ObjString *separator = patternArgument(args[1], "split");
+    if (separator == NULL) return NIL_VAL;
+
+    ObjString *string = AS_STRING(args[0]);
+    ObjList *list = newList();
+    push(OBJ_VAL(list));
+    if (!listReserve(list, countOccurrences(string, separator) + 1)) return NIL_VAL;
+
+    int start = 0;
+    for (;;) {
+        int end = findBytes(string->chars, string->length, separator->chars,
+                            separator->length, start);
+        int pieceEnd = end == -1 ? string->length : end;
+        Value piece = OBJ_VAL(copyString(string->chars + start, pieceEnd - start));
+        push(piece);
+        listAppend(list, piece);
+        pop();
+        if (end == -1) break;
+        start = end + separator->length;
+    }
+
+    pop();
+    return OBJ_VAL(list);
+}
+
+// the receiver goes between the elements: ", ".join(parts)
+Value stringJoinNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_STRING(args[0]) || !IS_LIST(args[1])) {
+        runtimeError("join() expects a list of strings.");
+        return NIL_VAL;
+    }
+
+    ObjString *separator = AS_STRING(args[0]);
+    ValueArray *parts = &AS_LIST(args[1])->items;
+    if (parts->count == 0) return OBJ_VAL(copyString("", 0));
+
+    size_t length = (size_t)separator->length * (size_t)(parts->count - 1);
+    for (int i = 0; i < parts->count; i++) {
+        if (!IS_STRING(parts->values[i])) {
+            runtimeError("join() expects a list of strings.");
+            return NIL_VAL;
+        }
+        length += (size_t)AS_STRING(parts->values[i])->length;
+    }
+    if (length > INT_MAX - 1) {
+        runtimeError("join() result is too long.");
+        return NIL_VAL;
+    }
+
+    char *chars = ALLOCATE(char, length + 1);
+    if (chars == NULL) return NIL_VAL;
+    char *next = chars;
+    for (int i = 0; i < parts->count; i++) {
+        if (i > 0) {
+            memcpy(next, separator->chars, (size_t)separator->length);
+            next += separator->length;
+        }
+        ObjString *part = AS_STRING(parts->values[i]);
+        memcpy(next, part->chars, (size_t)part->length);
+        next += part->length;
+    }
+    *next = '\0';
+    return OBJ_VAL(takeString(chars, (int)length));
+}
+
+// replaces every occurrence, scanning left to right without overlaps
+Value stringReplaceNative(int argCount, Value *args)
+{
+    if (argCount != 3 || !IS_STRING(args[0]) || !IS_STRING(args[2])) {
+        runtimeError("replace() expects a string to search for and its replacement.");
+        return NIL_VAL;
+    }
+    ObjString *pattern = patternArgument(args[1], "replace");
+    if (pattern == NULL) return NIL_VAL;
+
+    ObjString *string = AS_STRING(args[0]);
+    ObjString *replacement = AS_STRING(args[2]);
+    int count = countOccurrences(string, pattern);
+    if (count == 0) return args[0];
+
+    long long length = (long long)string->length +
+                       (long long)count * (replacement->length - pattern->length);
+    if (length > INT_MAX - 1) {
+        runtimeError("replace() result is too long.");
+        return NIL_VAL;
+    }
+
+    char *chars = ALLOCATE(char, (size_t)length + 1);
+    if (chars == NULL) return NIL_VAL;
+    char *next = chars;
+    int start = 0;
+    for (int i = 0; i < count; i++) {
+        int at = findBytes(string->chars, string->length, pattern->chars,
+                           pattern->length, start);
+        memcpy(next, string->chars + start, (size_t)(at - start));
+        next += at - start;
+        memcpy(next, replacement->chars, (size_t)replacement->length);
+        next += replacement->length;
+        start = at + pattern->length;
+    }
+    memcpy(next, string->chars + start, (size_t)(string->length - start));
+    chars[length] = '\0';
+    return OBJ_VAL(takeString(chars, (int)length));
+}
+
+Value stringStartsWithNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_STRING(args[0]) || !IS_STRING(args[1])) {
+        runtimeError("startsWith() expects a string.");
+        return NIL_VAL;
+    }
+
+    ObjString *string = AS_STRING(args[0]);
+    ObjString *prefix = AS_STRING(args[1]);
+    return BOOL_VAL(prefix->length <= string->length &&
+                    memcmp(string->chars, prefix->chars, (size_t)prefix->length) == 0);
+}
+
+Value stringEndsWithNative(int argCount, Value *args)
+{
+    if (argCount != 2 || !IS_STRING(args[0]) || !IS_STRING(args[1])) {
+        runtimeError("endsWith() expects a string.");
+        return NIL_VAL;
+    }
+
+    ObjString *string = AS_STRING(args[0]);
+    ObjString *suffix = AS_STRING(args[1]);
+    return BOOL_VAL(suffix->length <= string->length &&
+                    memcmp(string->chars + string->length - suffix->length,
+                           suffix->chars, (size_t)suffix->length) == 0);
+}
+
+static bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+Value stringTrimNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING(args[0])) {
+        runtimeError("trim() expects no arguments.");
+        return NIL_VAL;
+    }
+
+    ObjString *string = AS_STRING(args[0]);
+    int start = 0;
+    int end = string->length;
+    while (start < end && isSpace(string->chars[start])) start++;
+    while (end > start && isSpace(string->chars[end - 1])) end--;
+    if (start == 0 && end == string->length) return args[0];
+    return OBJ_VAL(copyString(string->chars + start, end - start));
+}
+
+// only ASCII letters change case; every other byte is copied as it is
+static Value changeCase(Value value, char from, char to)
+{
+    ObjString *string = AS_STRING(value);
+    int first = 0;
+    while (first < string->length &&
+           (string->chars[first] < from || string->chars[first] > from + 25)) {
+        first++;
+    }
+    if (first == string->length) return value;
+
+    char *chars = ALLOCATE(char, string->length + 1);
+    if (chars == NULL) return value;
+    memcpy(chars, string->chars, (size_t)string->length + 1);
+    for (int i = first; i < string->length; i++) {
+        if (chars[i] >= from && chars[i] <= from + 25) chars[i] += to - from;
+    }
+    return OBJ_VAL(takeString(chars, string->length));
+}
+
+Value stringUpperNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING(args[0])) {
+        runtimeError("upper() expects no arguments.");
+        return NIL_VAL;
+    }
+    return changeCase(args[0], 'a', 'A');
+}
+
+Value stringLowerNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING(args[0])) {
+        runtimeError("lower() expects no arguments.");
+        return NIL_VAL;
+    }
+    return changeCase(args[0], 'A', 'a');
+}
+
+Value stringBytesNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_STRING(args[0])) {
+        runtimeError("bytes() expects no arguments.");
+        return NIL_VAL;
+    }
+    return OBJ_VAL(newBytes(AS_STRING(args[0])));
+}
+
+// one-byte strings all exist from startup, so chr never allocates
+Value chrNative(int argCount, Value *args)
+{
+    if (argCount != 1 || !IS_NUMBER(args[0])) {
+        runtimeError("chr() expects a byte value from 0 to 255.");
+        return NIL_VAL;
+    }
+
+    double byte = AS_NUMBER(args[0]);
+    if (floor(byte) != byte || byte < 0 || byte > 255) {
+        runtimeError("chr() expects a byte value from 0 to 255.");
+        return NIL_VAL;
+    }
+    return OBJ_VAL(vm.byteStrings[(int)byte]);
+}
+
+Value ordNative(int argCount, Value *args)
+{
+    if ((argCount != 1 && argCount != 2) || !IS_STRING(args[0]) ||
+        (argCount == 2 && !IS_NUMBER(args[1]))) {
+        runtimeError("ord() expects a string and an optional index.");
+        return NIL_VAL;
+    }
+
+    ObjString *string = AS_STRING(args[0]);
+    double index = argCount == 2 ? AS_NUMBER(args[1]) : 0;
+    if (floor(index) != index || index < 0 || index >= string->length) {
+        runtimeError("String index out of bounds.");
+        return NIL_VAL;
+    }
+    return NUMBER_VAL((uint8_t)string->chars[(int)index]);
+}
+
+Value lenNative(int argCount, Value *args)
+{
+    if (argCount != 1) {
+        runtimeError("len() expects one value.");
+        return NIL_VAL;
+    }
+
+    if (IS_STRING(args[0])) return NUMBER_VAL(AS_STRING(args[0])->length);
+    if (IS_LIST(args[0])) return NUMBER_VAL(AS_LIST(args[0])->items.count);
+    if (IS_HASHMAP(args[0])) return NUMBER_VAL(mapCount(&AS_HASHMAP(args[0])->items));
+    if (IS_SET(args[0])) return NUMBER_VAL(setCount(&AS_SET(args[0])->items));
+    if (IS_PRIORITY_QUEUE(args[0])) {
+        return NUMBER_VAL(AS_PRIORITY_QUEUE(args[0])->items.count);
+    }
+    if (IS_FLOAT_ARRAY(args[0])) return NUMBER_VAL(AS_FLOAT_ARRAY(args[0])->count);
+    if (IS_RANGE(args[0])) return NUMBER_VAL(rangeCount(AS_RANGE(args[0])));
+    if (IS_STRING_BUILDER(args[0])) {
+        return NUMBER_VAL(AS_STRING_BUILDER(args[0])->builder.count);
+    }
+    if (IS_BYTES(args[0])) return NUMBER_VAL(AS_BYTES(args[0])->string->length);
 
-    runtimeError("len() expects a string, list, or map.");
+    runtimeError("len() expects a string or a collection.");
     return NIL_VAL;
 }
 
@@ -493,6 +1558,13 @@ Value typeNative(int argCount, Value *args)
     else if (IS_STRING(args[0])) name = "string";
     else if (IS_LIST(args[0])) name = "list";
     else if (IS_HASHMAP(args[0])) name = "map";
+    else if (IS_SET(args[0])) name = "set";
+    else if (IS_PRIORITY_QUEUE(args[0])) name = "priority_queue";
+    else if (IS_FLOAT_ARRAY(args[0])) name = "float_array";
+    else if (IS_RANGE(args[0])) name = "range";
+    else if (IS_SEQUENCE(args[0])) name = "sequence";
+    else if (IS_STRING_BUILDER(args[0])) name = "string_builder";
+    else if (IS_BYTES(args[0])) name = "bytes";
     else if (IS_CLOSURE(args[0])) name = "function";
     else if (IS_NATIVE(args[0])) name = "native";
     else if (IS_CLASS(args[0])) name = "class";
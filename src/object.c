@@ -1,46 +1,46 @@
-#include <stdio.h>
-#include <string.h>
-
-#include "headers/memory.h"
-#include "headers/object.h"
-#include "headers/table.h"
-#include "headers/value.h"
-#include "headers/vm.h"
-
-#define ALLOCATE_OBJ(type, objectType) \
-  (type*)allocateObject(sizeof(type), objectType)
-
-static Obj* allocateObject(size_t size, ObjType type) {
-  Obj* object = (Obj*)reallocate(NULL, 0, size);
-  object->type = type;
-  object->isMarked = false;
-  object->next = vm.objects;
-  vm.objects = object;
-#ifdef DEBUG_LOG_GC
-  printf("%p allocate %zu for %d\n", (void*)object, size, type);
-#endif
-  return object;
-}
-
-ObjFunction* newFunction() {
+#include <stdio.h>
+#include <string.h>
+
+#include "headers/memory.h"
+#include "headers/object.h"
+#include "headers/table.h"
+#include "headers/value.h"
+#include "headers/vm.h"
+
+#define ALLOCATE_OBJ(type, objectType) \
+  (type*)allocateObject(sizeof(type), objectType)
+
+static Obj* allocateObject(size_t size, ObjType type) {
+  Obj* object = allocateObjectSlot(size);
+  object->type = type;
+  object->isMarked = false;
+  vm.gcStats.liveObjects[type]++;
+#ifdef DEBUG_LOG_GC
+  printf("%p allocate %zu for %d\n", (void*)object, size, type);
+#endif
+  return object;
+}
+
+ObjFunction* newFunction() {
   ObjFunction* function = ALLOCATE_OBJ(ObjFunction, OBJ_FUNCTION);
   function->arity = 0;
   function->upvalueCount = 0;
   function->name = NULL;
   function->sourceName = NULL;
-  initChunk(&function->chunk);
-
+  initChunk(&function->chunk);
+
   return function;
 }
 
 ObjClosure* newClosure(ObjFunction* function) {
   ObjUpvalue** upvalues = ALLOCATE(ObjUpvalue*, function->upvalueCount);
-  for (int i = 0; i < function->upvalueCount; i++) upvalues[i] = NULL;
+  int upvalueCount = upvalues == NULL ? 0 : function->upvalueCount;
+  for (int i = 0; i < upvalueCount; i++) upvalues[i] = NULL;
 
   ObjClosure* closure = ALLOCATE_OBJ(ObjClosure, OBJ_CLOSURE);
   closure->function = function;
   closure->upvalues = upvalues;
-  closure->upvalueCount = function->upvalueCount;
+  closure->upvalueCount = upvalueCount;
   closure->module = NULL;
   return closure;
 }
@@ -52,7 +52,7 @@ ObjUpvalue* newUpvalue(Value* slot) {
   upvalue->next = NULL;
   return upvalue;
 }
-
+
 ObjNative* newNative(NativeFn function) {
   ObjNative* native = ALLOCATE_OBJ(ObjNative, OBJ_NATIVE);
   native->legacyFunction = function;
@@ -68,81 +68,258 @@ ObjNative* newHostNative(PbNativeFn function, void* userData) {
   native->userData = userData;
   return native;
 }
-
-static ObjString* allocateString(char* chars, int length, uint32_t hash) {
-  ObjString* string = ALLOCATE_OBJ(ObjString, OBJ_STRING);
-  string->length = length;
-  string->chars = chars;
-  string->hash = hash;
-
-  push(OBJ_VAL(string));
-  tableSet(&vm.strings, string, NIL_VAL); // val nil as we only care about the key (string)
-  pop();
-  return string;
-}
-
-static uint32_t hashString(const char* key, int length) {
-  uint32_t hash = 2166136261u;
-  for (int i = 0; i < length; i++) {
-    hash ^= (uint8_t)key[i];
-    hash *= 16777619;
-  }
-  return hash;
-}
-
-ObjString* takeString(char* chars, int length) {
-  uint32_t hash = hashString(chars, length);
-  ObjString* interned = tableFindString(&vm.strings, chars, length, hash);
-
-  if (interned != NULL) {
-    FREE_ARRAY(char, chars, length + 1);
-    return interned;
-  }
-
-  return allocateString(chars, length, hash);
-}
-
-ObjString* copyString(const char* chars, int length) {
-  uint32_t hash = hashString(chars, length);
-  ObjString* interned = tableFindString(&vm.strings, chars, length, hash);
-  if (interned != NULL) return interned;
-  char* heapChars = ALLOCATE(char, length + 1);
-  memcpy(heapChars, chars, length);
-  heapChars[length] = '\0';
-  return allocateString(heapChars, length, hash);
-}
-
-ObjList* newList() {
-  ObjList* list = ALLOCATE_OBJ(ObjList, OBJ_LIST);
-  // push(OBJ_VAL(list));
-  initValueArray(&list->items);
-  return list;
-}
-
+
+static ObjString* allocateString(char* chars, int length, uint32_t hash) {
+  ObjString* string = ALLOCATE_OBJ(ObjString, OBJ_STRING);
+  string->length = length;
+  string->chars = chars;
+  string->hash = hash;
+
+  push(OBJ_VAL(string));
+  tableSet(&vm.strings, string, NIL_VAL); // val nil as we only care about the key (string)
+  pop();
+  return string;
+}
+
+static uint32_t hashString(const char* key, int length) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < length; i++) {
+    hash ^= (uint8_t)key[i];
+    hash *= 16777619;
+  }
+  return hash;
+}
+
+// a string whose characters could not be allocated comes back empty; the
+// out-of-memory error is already raised and ends the script
+ObjString* takeString(char* chars, int length) {
+  if (chars == NULL) return vm.emptyString;
+  uint32_t hash = hashString(chars, length);
+  ObjString* interned = tableFindString(&vm.strings, chars, length, hash);
+
+  if (interned != NULL) {
+    FREE_ARRAY(char, chars, length + 1);
+    return interned;
+  }
+
+  return allocateString(chars, length, hash);
+}
+
+ObjString* copyString(const char* chars, int length) {
+  uint32_t hash = hashString(chars, length);
+  ObjString* interned = tableFindString(&vm.strings, chars, length, hash);
+  if (interned != NULL) return interned;
+  char* heapChars = ALLOCATE(char, length + 1);
+  if (heapChars == NULL) return vm.emptyString;
+  memcpy(heapChars, chars, length);
+  heapChars[length] = '\0';
+  return allocateString(heapChars, length, hash);
+}
+
+ObjList* newList() {
+  ObjList* list = ALLOCATE_OBJ(ObjList, OBJ_LIST);
+  // push(OBJ_VAL(list));
+  initValueArray(&list->items);
+  list->front = 0;
+  return list;
+}
+
+static Value* listBase(ObjList* list) {
+  return list->items.values - list->front;
+}
+
+void freeList(ObjList* list) {
+  FREE_ARRAY(Value, listBase(list), list->front + list->items.capacity);
+  initValueArray(&list->items);
+  list->front = 0;
+}
+
+size_t listBytes(ObjList* list) {
+  return (size_t)(list->front + list->items.capacity) * sizeof(Value);
+}
+
+// gives the released front slots back to the end of the list
+static void listDropFront(ObjList* list) {
+  if (list->front == 0) return;
+
+  Value* base = listBase(list);
+  memmove(base, list->items.values, sizeof(Value) * (size_t)list->items.count);
+  list->items.values = base;
+  list->items.capacity += list->front;
+  list->front = 0;
+}
+
+// false, with the list unchanged, when the memory is refused
+bool listReserve(ObjList* list, int capacity) {
+  if (list->items.capacity >= capacity) return true;
+
+  // front slots are kept across a grow only while they are few next to the
+  // elements, which bounds the waste of a list used as a queue
+  if (list->front > list->items.count) {
+    listDropFront(list);
+    if (list->items.capacity >= capacity) return true;
+  }
+
+  int oldTotal = list->front + list->items.capacity;
+  Value* base = GROW_ARRAY(Value, listBase(list), oldTotal, list->front + capacity);
+  if (base == NULL) return false;
+  list->items.values = base + list->front;
+  list->items.capacity = capacity;
+  return true;
+}
+
+void listShrinkToFit(ObjList* list) {
+  listDropFront(list);
+  int count = list->items.count;
+  Value* values = GROW_ARRAY(Value, list->items.values,
+                             list->items.capacity, count);
+  if (values == NULL && count > 0) return;
+  list->items.values = values;
+  list->items.capacity = count;
+}
+
+bool listAppend(ObjList* list, Value value) {
+  if (list->items.capacity < list->items.count + 1 &&
+      !listReserve(list, GROW_CAPACITY(list->items.capacity))) {
+    return false;
+  }
+  list->items.values[list->items.count++] = value;
+  return true;
+}
+
+// reallocates with free slots before the first element, as many as there
+// are elements, so a run of inserts at the front is amortized O(1)
+static bool listMakeFrontRoom(ObjList* list) {
+  int slack = list->items.count < 8 ? 8 : list->items.count;
+  int total = slack + list->items.capacity;
+  Value* base = ALLOCATE(Value, total);
+  if (base == NULL) return false;
+  memcpy(base + slack, list->items.values,
+         sizeof(Value) * (size_t)list->items.count);
+  FREE_ARRAY(Value, listBase(list), list->front + list->items.capacity);
+  list->items.values = base + slack;
+  list->front = slack;
+  return true;
+}
+
+// elements move toward whichever end is nearer, so both ends are O(1)
+void listInsertAt(ObjList* list, int index, Value value) {
+  ValueArray* items = &list->items;
+  if (index < items->count / 2) {
+    if (list->front == 0 && !listMakeFrontRoom(list)) return;
+    items->values--;
+    items->capacity++;
+    list->front--;
+    memmove(items->values, items->values + 1, sizeof(Value) * (size_t)index);
+  } else {
+    if (!listReserve(list, items->count + 1)) return;
+    memmove(&items->values[index + 1], &items->values[index],
+            sizeof(Value) * (size_t)(items->count - index));
+  }
+  items->values[index] = value;
+  items->count++;
+}
+
+Value listRemoveAt(ObjList* list, int index) {
+  ValueArray* items = &list->items;
+  Value value = items->values[index];
+  if (index < items->count / 2) {
+    memmove(items->values + 1, items->values, sizeof(Value) * (size_t)index);
+    items->values++;
+    items->capacity--;
+    list->front++;
+  } else {
+    memmove(&items->values[index], &items->values[index + 1],
+            sizeof(Value) * (size_t)(items->count - index - 1));
+  }
+  items->count--;
+  if (items->count == 0) listClear(list);
+  return value;
+}
+
+void listClear(ObjList* list) {
+  list->items.count = 0;
+  listDropFront(list);
+}
+
 ObjHashmap* newHashmap() {
   ObjHashmap* hashmap = ALLOCATE_OBJ(ObjHashmap, OBJ_HASHMAP);
   initMap(&hashmap->items);
-  return hashmap;
-}
-
-ObjClass* newClass(ObjString* name) {
-  ObjClass* klass = ALLOCATE_OBJ(ObjClass, OBJ_CLASS);
-  klass->name = name;
-  initTable(&klass->methods);
-  return klass;
-}
-
-ObjInstance* newInstance(ObjClass* klass) {
-  ObjInstance* instance = ALLOCATE_OBJ(ObjInstance, OBJ_INSTANCE);
-  instance->klass = klass;
-  initTable(&instance->fields);
-  return instance;
-}
-
+  return hashmap;
+}
+
+ObjSet* newSet() {
+  ObjSet* set = ALLOCATE_OBJ(ObjSet, OBJ_SET);
+  initSet(&set->items);
+  return set;
+}
+
+ObjPriorityQueue* newPriorityQueue(Value key) {
+  ObjPriorityQueue* queue = ALLOCATE_OBJ(ObjPriorityQueue, OBJ_PRIORITY_QUEUE);
+  queue->key = key;
+  initPriorityQueue(&queue->items);
+  return queue;
+}
+
+// every element starts at zero
+ObjFloatArray* newFloatArray(int count) {
+  double* values = ALLOCATE(double, count);
+  if (values == NULL) count = 0;
+  if (count > 0) memset(values, 0, sizeof(double) * (size_t)count);
+
+  ObjFloatArray* array = ALLOCATE_OBJ(ObjFloatArray, OBJ_FLOAT_ARRAY);
+  array->count = count;
+  array->values = values;
+  return array;
+}
+
+ObjRange* newRange(double start, double end, double step) {
+  ObjRange* range = ALLOCATE_OBJ(ObjRange, OBJ_RANGE);
+  range->start = start;
+  range->end = end;
+  range->step = step;
+  return range;
+}
+
+ObjSequence* newSequence(SequenceKind kind, Value source, Value function) {
+  ObjSequence* sequence = ALLOCATE_OBJ(ObjSequence, OBJ_SEQUENCE);
+  sequence->kind = kind;
+  sequence->source = source;
+  sequence->function = function;
+  return sequence;
+}
+
+ObjStringBuilder* newStringBuilder() {
+  ObjStringBuilder* builder = ALLOCATE_OBJ(ObjStringBuilder, OBJ_STRING_BUILDER);
+  builder->builder = (StringBuilder){0};
+  builder->builder.counted = true;
+  return builder;
+}
+
+ObjBytes* newBytes(ObjString* string) {
+  ObjBytes* bytes = ALLOCATE_OBJ(ObjBytes, OBJ_BYTES);
+  bytes->string = string;
+  return bytes;
+}
+
+ObjClass* newClass(ObjString* name) {
+  ObjClass* klass = ALLOCATE_OBJ(ObjClass, OBJ_CLASS);
+  klass->name = name;
+  initTable(&klass->methods);
+  return klass;
+}
+
+ObjInstance* newInstance(ObjClass* klass) {
+  ObjInstance* instance = ALLOCATE_OBJ(ObjInstance, OBJ_INSTANCE);
+  instance->klass = klass;
+  initTable(&instance->fields);
+  return instance;
+}
+
 ObjBoundMethod* newBoundMethod(Value receiver, ObjClosure* method) {
-  ObjBoundMethod* bound = ALLOCATE_OBJ(ObjBoundMethod, OBJ_BOUND_METHOD);
-  bound->receiver = receiver;
-  bound->method = method;
+  ObjBoundMethod* bound = ALLOCATE_OBJ(ObjBoundMethod, OBJ_BOUND_METHOD);
+  bound->receiver = receiver;
+  bound->method = method;
   return bound;
 }
 
@@ -154,24 +331,24 @@ ObjModule* newModule(ObjString* name) {
   module->isLoading = false;
   return module;
 }
-
-static void printFunction(ObjFunction* function) {
-  if (function->name == NULL) {
-    printf("<script>");
-    return;
-  }
-  printf("<fn %s>", function->name->chars);
-}
-
-static void printList(ObjList* list) {
-  printf("[");
-  for (int i = 0; i < list->items.count; i++) {
-    if (i > 0) printf(", ");
-    printValue(list->items.values[i]);
-  }
-  printf("]");
-}
-
+
+static void printFunction(ObjFunction* function) {
+  if (function->name == NULL) {
+    printf("<script>");
+    return;
+  }
+  printf("<fn %s>", function->name->chars);
+}
+
+static void printList(ObjList* list) {
+  printf("[");
+  for (int i = 0; i < list->items.count; i++) {
+    if (i > 0) printf(", ");
+    printValue(list->items.values[i]);
+  }
+  printf("]");
+}
+
 static void printHashmap(ObjHashmap* hashmap) {
   printf("{");
   bool first = true;
@@ -186,9 +363,30 @@ static void printHashmap(ObjHashmap* hashmap) {
     printf(": ");
     printValue(entry->value);
   }
-  printf("}");
-}
-
+  printf("}");
+}
+
+static void printSet(ObjSet* set) {
+  printf("Set{");
+  bool first = true;
+  for (int position = setNextKey(&set->items, -1); position != -1;
+       position = setNextKey(&set->items, position)) {
+    if (!first) printf(", ");
+    first = false;
+    printValue(SET_KEY_AT(&set->items, position));
+  }
+  printf("}");
+}
+
+static void printFloatArray(ObjFloatArray* array) {
+  printf("FloatArray[");
+  for (int i = 0; i < array->count; i++) {
+    if (i > 0) printf(", ");
+    printValue(NUMBER_VAL(array->values[i]));
+  }
+  printf("]");
+}
+
 void printObject(Value value) {
   switch (OBJ_TYPE(value)) {
     case OBJ_FUNCTION:
@@ -200,29 +398,65 @@ void printObject(Value value) {
     case OBJ_UPVALUE:
       printf("upvalue");
       break;
-    case OBJ_NATIVE:
-      printf("<native fn>");
-      break;
-    case OBJ_STRING:
-      printf("%s", AS_CSTRING(value));
-      break;
-    case OBJ_LIST:
-      printList(AS_LIST(value));
-      break;
-    case OBJ_HASHMAP:
-      printHashmap(AS_HASHMAP(value));  
-      break;
-    case OBJ_CLASS:
-      printf("%s", AS_CLASS(value)->name->chars);
-      break;
-    case OBJ_INSTANCE:
-      printf("%s instance", AS_INSTANCE(value)->klass->name->chars);
-      break; // vm debugger was crashing bc i forgot this, spent over an hour finding trouble elsewhere
+    case OBJ_NATIVE:
+      printf("<native fn>");
+      break;
+    case OBJ_STRING:
+      printf("%s", AS_CSTRING(value));
+      break;
+    case OBJ_LIST:
+      printList(AS_LIST(value));
+      break;
+    case OBJ_HASHMAP:
+      printHashmap(AS_HASHMAP(value));  
+      break;
+    case OBJ_CLASS:
+      printf("%s", AS_CLASS(value)->name->chars);
+      break;
+    case OBJ_INSTANCE:
+      printf("%s instance", AS_INSTANCE(value)->klass->name->chars);
+      break; // vm debugger was crashing bc i forgot this, spent over an hour finding trouble elsewhere
     case OBJ_BOUND_METHOD:
       printFunction(AS_BOUND_METHOD(value)->method->function);
       break;
     case OBJ_MODULE:
       printf("<module %s>", AS_MODULE(value)->name->chars);
       break;
+    case OBJ_SET:
+      printSet(AS_SET(value));
+      break;
+    case OBJ_PRIORITY_QUEUE:
+      printf("<priority queue>");
+      break;
+    case OBJ_FLOAT_ARRAY:
+      printFloatArray(AS_FLOAT_ARRAY(value));
+      break;
+    case OBJ_RANGE: {
+      ObjRange* range = AS_RANGE(value);
+      printf("range(");
+      printValue(NUMBER_VAL(range->start));
+      printf(", ");
+      printValue(NUMBER_VAL(range->end));
+      printf(", ");
+      printValue(NUMBER_VAL(range->step));
+      printf(")");
+      break;
+    }
+    case OBJ_SEQUENCE:
+      printf("<sequence>");
+      break;
+    case OBJ_STRING_BUILDER:
+      printf("<string builder>");
+      break;
+    case OBJ_BYTES: {
+      ObjString* string = AS_BYTES(value)->string;
+      printf("Bytes[");
+      for (int i = 0; i < string->length; i++) {
+        if (i > 0) printf(", ");
+        printf("%d", (uint8_t)string->chars[i]);
+      }
+      printf("]");
+      break;
+    }
   }
 }
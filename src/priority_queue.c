@@ -0,0 +1,130 @@
+#include <math.h>
+#include <string.h>
+
+#include "headers/memory.h"
+#include "headers/object.h"
+#include "headers/priority_queue.h"
+
+// four children per node halve the depth of a binary heap and keep the
+// children of a node within two cache lines
+#define QUEUE_ARITY 4
+
+void initPriorityQueue(PriorityQueue* queue) {
+  queue->count = 0;
+  queue->capacity = 0;
+  queue->strings = false;
+  queue->nextOrder = 0;
+  queue->entries = NULL;
+}
+
+void freePriorityQueue(PriorityQueue* queue) {
+  FREE_ARRAY(QueueEntry, queue->entries, queue->capacity);
+  initPriorityQueue(queue);
+}
+
+void markPriorityQueue(PriorityQueue* queue) {
+  for (int i = 0; i < queue->count; i++) {
+    if (queue->strings) markObject((Obj*)queue->entries[i].priority.string);
+    markValue(queue->entries[i].item);
+  }
+}
+
+size_t priorityQueueBytes(PriorityQueue* queue) {
+  return sizeof(QueueEntry) * (size_t)queue->capacity;
+}
+
+bool priorityQueueAccepts(PriorityQueue* queue, Value priority) {
+  if (IS_NUMBER(priority)) {
+    return !isnan(AS_NUMBER(priority)) && (queue->count == 0 || !queue->strings);
+  }
+  return IS_STRING(priority) && (queue->count == 0 || queue->strings);
+}
+
+static inline int compareStrings(ObjString* left, ObjString* right) {
+  int length = left->length < right->length ? left->length : right->length;
+  int result = memcmp(left->chars, right->chars, (size_t)length);
+  if (result != 0) return result;
+  return left->length - right->length;
+}
+
+static inline bool entryLess(PriorityQueue* queue, QueueEntry* left,
+                             QueueEntry* right) {
+  if (queue->strings) {
+    if (left->priority.string != right->priority.string) {
+      int result = compareStrings(left->priority.string, right->priority.string);
+      if (result != 0) return result < 0;
+    }
+  } else if (left->priority.number != right->priority.number) {
+    return left->priority.number < right->priority.number;
+  }
+  return left->order < right->order;
+}
+
+// the moving entry is held aside and written once, into the final hole
+static void siftUp(PriorityQueue* queue, int position) {
+  QueueEntry entry = queue->entries[position];
+  while (position > 0) {
+    int parent = (position - 1) / QUEUE_ARITY;
+    if (!entryLess(queue, &entry, &queue->entries[parent])) break;
+    queue->entries[position] = queue->entries[parent];
+    position = parent;
+  }
+  queue->entries[position] = entry;
+}
+
+static void siftDown(PriorityQueue* queue, int position) {
+  QueueEntry entry = queue->entries[position];
+  for (;;) {
+    int first = position * QUEUE_ARITY + 1;
+    if (first >= queue->count) break;
+
+    int last = first + QUEUE_ARITY < queue->count ? first + QUEUE_ARITY
+                                                  : queue->count;
+    int smallest = first;
+    for (int child = first + 1; child < last; child++) {
+      if (entryLess(queue, &queue->entries[child], &queue->entries[smallest])) {
+        smallest = child;
+      }
+    }
+    if (!entryLess(queue, &queue->entries[smallest], &entry)) break;
+
+    queue->entries[position] = queue->entries[smallest];
+    position = smallest;
+  }
+  queue->entries[position] = entry;
+}
+
+// the priority must have passed priorityQueueAccepts, and both values must
+// be reachable, since growing the entries can collect
+void priorityQueuePush(PriorityQueue* queue, Value priority, Value item) {
+  if (queue->count == queue->capacity) {
+    int capacity = GROW_CAPACITY(queue->capacity);
+    QueueEntry* entries = GROW_ARRAY(QueueEntry, queue->entries,
+                                     queue->capacity, capacity);
+    if (entries == NULL) return;
+    queue->entries = entries;
+    queue->capacity = capacity;
+  }
+
+  QueueEntry* entry = &queue->entries[queue->count];
+  queue->strings = IS_STRING(priority);
+  if (queue->strings) {
+    entry->priority.string = AS_STRING(priority);
+  } else {
+    entry->priority.number = AS_NUMBER(priority);
+  }
+  entry->order = queue->nextOrder++;
+  entry->item = item;
+  siftUp(queue, queue->count++);
+}
+
+// the queue must not be empty
+Value priorityQueuePop(PriorityQueue* queue) {
+  Value item = queue->entries[0].item;
+  queue->count--;
+  if (queue->count > 0) {
+    queue->entries[0] = queue->entries[queue->count];
+    siftDown(queue, 0);
+  }
+  return item;
+}
@@ -0,0 +1,71 @@
+#include <math.h>
+
+#include "headers/range.h"
+#include "headers/vm.h"
+
+static bool isRangeBound(Value value) {
+  if (!IS_NUMBER(value)) return false;
+  double number = AS_NUMBER(value);
+  return floor(number) == number && fabs(number) <= RANGE_LIMIT;
+}
+
+// range(end), range(start, end) and range(start, end, step), with the
+// errors reported on behalf of range()
+bool rangeArguments(int argCount, Value* args, double* start, double* end,
+                    double* step) {
+  if (argCount < 1 || argCount > 3) {
+    runtimeError("range() expects an end, or a start, end and optional step.");
+    return false;
+  }
+  for (int i = 0; i < argCount; i++) {
+    if (!isRangeBound(args[i])) {
+      runtimeError("range() arguments must be integers.");
+      return false;
+    }
+  }
+
+  *start = argCount == 1 ? 0 : AS_NUMBER(args[0]);
+  *end = AS_NUMBER(args[argCount == 1 ? 0 : 1]);
+  *step = argCount == 3 ? AS_NUMBER(args[2]) : 1;
+  if (*step == 0) {
+    runtimeError("range() step must not be zero.");
+    return false;
+  }
+  return true;
+}
+
+double rangeCount(ObjRange* range) {
+  double span = range->step > 0 ? range->end - range->start
+                                : range->start - range->end;
+  if (span <= 0) return 0;
+  return ceil(span / fabs(range->step));
+}
+
+bool sequenceNext(Value sequence, double* position, Value* element) {
+  if (IS_RANGE(sequence)) {
+    ObjRange* range = AS_RANGE(sequence);
+    double next = range->start + *position * range->step;
+    if (range->step > 0 ? next >= range->end : next <= range->end) return false;
+    *element = NUMBER_VAL(next);
+    (*position)++;
+    return true;
+  }
+
+  // a filter stage pulls from its source until an element passes
+  ObjSequence* stage = AS_SEQUENCE(sequence);
+  for (;;) {
+    Value input;
+    if (!sequenceNext(stage->source, position, &input)) return false;
+
+    Value output;
+    if (!callFromNative(stage->function, 1, &input, &output)) return false;
+    if (stage->kind == SEQUENCE_MAP) {
+      *element = output;
+      return true;
+    }
+    if (!isFalsey(output)) {
+      *element = input;
+      return true;
+    }
+  }
+}
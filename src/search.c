@@ -0,0 +1,176 @@
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SEARCH_USE_SSE2
+#endif
+
+#include "headers/object.h"
+#include "headers/search.h"
+#include "headers/vm.h"
+
+#ifdef SEARCH_USE_SSE2
+// the kernels read a Value as 16 raw bytes: the tag in the first four, the
+// payload in the last eight, and padding in between that is never compared
+_Static_assert(sizeof(Value) == 16 && offsetof(Value, as) == 8 &&
+                   sizeof(ValueType) == 4,
+               "search kernels expect a 16-byte Value");
+#endif
+
+static inline int lowestBit(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int bit = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+// only these compare by contents; every other object is equal to itself alone
+static bool isStructural(Value value) {
+  if (!IS_OBJ(value)) return false;
+  switch (OBJ_TYPE(value)) {
+    case OBJ_LIST:
+    case OBJ_HASHMAP:
+    case OBJ_SET:
+    case OBJ_FLOAT_ARRAY:
+    case OBJ_RANGE:
+    case OBJ_BYTES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Numbers compare as doubles, so 0 finds -0 and NaN finds nothing.
+static int nextNumber(const Value* values, int count, int start, double needle) {
+  int i = start;
+#ifdef SEARCH_USE_SSE2
+  __m128d target = _mm_set1_pd(needle);
+  __m128i numberTag = _mm_set1_epi32(VAL_NUMBER);
+  for (; i + 2 <= count; i += 2) {
+    __m128i first = _mm_loadu_si128((const __m128i*)(values + i));
+    __m128i second = _mm_loadu_si128((const __m128i*)(values + i + 1));
+    // lanes 0 and 2 of tags hold the two tags
+    __m128i tags = _mm_cmpeq_epi32(_mm_unpacklo_epi64(first, second), numberTag);
+    __m128d numbers = _mm_castsi128_pd(_mm_unpackhi_epi64(first, second));
+    int tagBits = _mm_movemask_ps(_mm_castsi128_ps(tags));
+    int numberBits = _mm_movemask_pd(_mm_cmpeq_pd(numbers, target));
+    int matches = numberBits & ((tagBits & 1) | ((tagBits >> 1) & 2));
+    if (matches != 0) return i + lowestBit((unsigned)matches);
+  }
+#endif
+  for (; i < count; i++) {
+    if (IS_NUMBER(values[i]) && AS_NUMBER(values[i]) == needle) return i;
+  }
+  return -1;
+}
+
+// nil, booleans, strings, which are all interned, and identity objects match
+// on their tag and as much of the payload as the kind uses
+static int nextExact(const Value* values, int count, int start, Value needle) {
+  int i = start;
+#ifdef SEARCH_USE_SSE2
+  int payloadBytes = IS_NIL(needle) ? 0 : IS_BOOL(needle) ? (int)sizeof(bool) : 8;
+  uint8_t maskBytes[16] = {0xff, 0xff, 0xff, 0xff};
+  memset(maskBytes + 8, 0xff, (size_t)payloadBytes);
+  __m128i mask = _mm_loadu_si128((const __m128i*)maskBytes);
+  __m128i target = _mm_and_si128(_mm_loadu_si128((const __m128i*)&needle), mask);
+
+  for (; i + 4 <= count; i += 4) {
+    int matches = 0;
+    for (int lane = 0; lane < 4; lane++) {
+      __m128i value = _mm_and_si128(_mm_loadu_si128((const __m128i*)(values + i + lane)), mask);
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(value, target)) == 0xffff) {
+        matches |= 1 << lane;
+      }
+    }
+    if (matches != 0) return i + lowestBit((unsigned)matches);
+  }
+#endif
+  for (; i < count; i++) {
+    Value value = values[i];
+    if (value.type != needle.type) continue;
+    if (IS_NIL(needle) ||
+        (IS_BOOL(needle) && AS_BOOL(value) == AS_BOOL(needle)) ||
+        (IS_OBJ(needle) && AS_OBJ(value) == AS_OBJ(needle))) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int nextStructural(const Value* values, int count, int start, Value needle) {
+  for (int i = start; i < count; i++) {
+    if (valuesEqual(values[i], needle)) return i;
+    if (vm.hadRuntimeError) return -1;
+  }
+  return -1;
+}
+
+static int nextMatch(const Value* values, int count, int start, Value needle) {
+  if (IS_NUMBER(needle)) return nextNumber(values, count, start, AS_NUMBER(needle));
+  if (isStructural(needle)) return nextStructural(values, count, start, needle);
+  return nextExact(values, count, start, needle);
+}
+
+int findValue(const Value* values, int count, Value needle) {
+  return nextMatch(values, count, 0, needle);
+}
+
+int countValue(const Value* values, int count, Value needle) {
+  int matches = 0;
+  for (int i = nextMatch(values, count, 0, needle); i != -1;
+       i = nextMatch(values, count, i + 1, needle)) {
+    matches++;
+  }
+  return matches;
+}
+
+int findBytes(const char* haystack, int length, const char* needle,
+              int needleLength, int start) {
+  if (needleLength == 0) return start <= length ? start : -1;
+  if (needleLength > length - start) return -1;
+
+  if (needleLength == 1) {
+    const char* found = memchr(haystack + start, needle[0], (size_t)(length - start));
+    return found == NULL ? -1 : (int)(found - haystack);
+  }
+
+  int i = start;
+  int last = needleLength - 1;
+#ifdef SEARCH_USE_SSE2
+  __m128i firstByte = _mm_set1_epi8(needle[0]);
+  __m128i lastByte = _mm_set1_epi8(needle[last]);
+  // the blocks cover the candidates i .. i + 15 and their last bytes
+  for (; i + last + 16 <= length; i += 16) {
+    __m128i firsts = _mm_loadu_si128((const __m128i*)(haystack + i));
+    __m128i lasts = _mm_loadu_si128((const __m128i*)(haystack + i + last));
+    unsigned candidates = (unsigned)_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(firsts, firstByte), _mm_cmpeq_epi8(lasts, lastByte)));
+    while (candidates != 0) {
+      int candidate = i + lowestBit(candidates);
+      if (memcmp(haystack + candidate + 1, needle + 1, (size_t)(last - 1)) == 0) {
+        return candidate;
+      }
+      candidates &= candidates - 1;
+    }
+  }
+#endif
+  while (i + last < length) {
+    const char* found = memchr(haystack + i, needle[0], (size_t)(length - last - i));
+    if (found == NULL) return -1;
+    i = (int)(found - haystack);
+    if (haystack[i + last] == needle[last] &&
+        memcmp(haystack + i + 1, needle + 1, (size_t)(last - 1)) == 0) {
+      return i;
+    }
+    i++;
+  }
+  return -1;
+}
@@ -0,0 +1,143 @@
+#include <string.h>
+
+#include "headers/hash_index.h"
+#include "headers/map.h"
+#include "headers/memory.h"
+#include "headers/set.h"
+
+// a deleted key; no key a set admits is an object without a pointer
+#define SET_HOLE ((Value){VAL_OBJ, {.obj = NULL}})
+#define IS_HOLE(value) (IS_OBJ(value) && AS_OBJ(value) == NULL)
+
+static int usableKeys(int indexCapacity) {
+  return indexCapacity / 2;
+}
+
+static size_t storageBytes(int indexCapacity) {
+  if (indexCapacity == 0) return 0;
+  return (size_t)usableKeys(indexCapacity) * sizeof(Value) +
+         hashIndexBytes(indexCapacity);
+}
+
+size_t setBytes(Set* set) {
+  return storageBytes(set->indexCapacity);
+}
+
+void initSet(Set* set) {
+  set->count = 0;
+  set->used = 0;
+  set->capacity = 0;
+  set->indexCapacity = 0;
+  set->keys = NULL;
+  set->index = NULL;
+  set->modifications = 0;
+}
+
+// the count of modifications carries on, since emptying a set is one too
+void freeSet(Set* set) {
+  FREE_ARRAY(char, set->keys, storageBytes(set->indexCapacity));
+  uint32_t modifications = set->modifications;
+  initSet(set);
+  set->modifications = modifications + 1;
+}
+
+static int findSlot(Set* set, Value key) {
+  if (set->indexCapacity == 0) return -1;
+
+  uint32_t hash = mapKeyHash(key);
+  uint32_t mask = (uint32_t)set->indexCapacity - 1;
+  uint32_t perturb = hash;
+  for (uint32_t slot = hash & mask;; HASH_INDEX_NEXT(slot, perturb, mask)) {
+    int position = hashIndexGet(set->index, set->indexCapacity, (int)slot);
+    if (position == HASH_INDEX_EMPTY) return -1;
+    if (position == HASH_INDEX_DELETED) continue;
+
+    if (hashKeysMatch(set->keys[position], key)) return (int)slot;
+  }
+}
+
+// moves the live keys to the front of a fresh allocation, in order; the
+// set is left as it was when the new storage is refused
+static bool rebuild(Set* set, int liveTarget) {
+  int indexCapacity = HASH_INDEX_MIN;
+  while (usableKeys(indexCapacity) < liveTarget) indexCapacity *= 2;
+
+  char* storage = ALLOCATE(char, storageBytes(indexCapacity));
+  if (storage == NULL) return false;
+  Set rebuilt;
+  rebuilt.count = set->count;
+  rebuilt.modifications = set->modifications + 1;
+  rebuilt.used = 0;
+  rebuilt.capacity = usableKeys(indexCapacity);
+  rebuilt.indexCapacity = indexCapacity;
+  rebuilt.keys = (Value*)storage;
+  rebuilt.index = storage + (size_t)rebuilt.capacity * sizeof(Value);
+  hashIndexClear(rebuilt.index, indexCapacity);
+
+  for (int i = 0; i < set->used; i++) {
+    Value key = set->keys[i];
+    if (IS_HOLE(key)) continue;
+    int slot = hashIndexFindEmpty(rebuilt.index, indexCapacity, mapKeyHash(key));
+    hashIndexSet(rebuilt.index, indexCapacity, slot, rebuilt.used);
+    rebuilt.keys[rebuilt.used++] = key;
+  }
+
+  FREE_ARRAY(char, set->keys, storageBytes(set->indexCapacity));
+  *set = rebuilt;
+  return true;
+}
+
+bool setHas(Set* set, Value key) {
+  return findSlot(set, key) != -1;
+}
+
+bool setAdd(Set* set, Value key) {
+  if (findSlot(set, key) != -1) return false;
+
+  if (set->used == set->capacity &&
+      !rebuild(set, set->count == 0 ? 1 : set->count * 2)) {
+    return false;
+  }
+
+  int slot = hashIndexFindEmpty(set->index, set->indexCapacity, mapKeyHash(key));
+  hashIndexSet(set->index, set->indexCapacity, slot, set->used);
+  set->keys[set->used++] = key;
+  set->count++;
+  set->modifications++;
+  return true;
+}
+
+bool setDelete(Set* set, Value key) {
+  int slot = findSlot(set, key);
+  if (slot == -1) return false;
+
+  set->keys[hashIndexGet(set->index, set->indexCapacity, slot)] = SET_HOLE;
+  hashIndexSet(set->index, set->indexCapacity, slot, HASH_INDEX_DELETED);
+  set->count--;
+  set->modifications++;
+
+  if (set->count == 0) {
+    freeSet(set);
+  } else if (set->used > HASH_INDEX_MIN && set->count < set->used / 4) {
+    rebuild(set, set->count * 2);
+  }
+  return true;
+}
+
+int setCount(Set* set) {
+  return set->count;
+}
+
+// the position of the first live key after position, or -1
+int setNextKey(Set* set, int position) {
+  for (int i = position + 1; i < set->used; i++) {
+    if (!IS_HOLE(set->keys[i])) return i;
+  }
+  return -1;
+}
+
+void markSet(Set* set) {
+  for (int i = 0; i < set->used; i++) {
+    if (!IS_HOLE(set->keys[i])) markValue(set->keys[i]);
+  }
+}
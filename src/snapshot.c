@@ -0,0 +1,337 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "headers/memory.h"
+#include "headers/object.h"
+#include "headers/vm.h"
+
+// A snapshot is a graph with a synthetic root (id 0) pointing at everything
+// markRoots() reaches, and one node per live object (ids from 1, in address
+// order). Edges are stored compressed: node i's references are
+// edges[edgeStart[i] .. edgeStart[i + 1]).
+typedef struct {
+  Obj** objects;
+  size_t* sizes;
+  int nodeCount;
+  int* edgeStart;
+  int* edges;
+  int edgeCount;
+  int edgeCapacity;
+  bool failed;
+} HeapGraph;
+
+typedef struct {
+  PbWriteFn write;
+  void* userData;
+} SnapshotWriter;
+
+static const char* typeNames[] = {
+  [OBJ_FUNCTION] = "function",
+  [OBJ_CLOSURE] = "closure",
+  [OBJ_UPVALUE] = "upvalue",
+  [OBJ_NATIVE] = "native",
+  [OBJ_STRING] = "string",
+  [OBJ_LIST] = "list",
+  [OBJ_HASHMAP] = "map",
+  [OBJ_CLASS] = "class",
+  [OBJ_INSTANCE] = "instance",
+  [OBJ_BOUND_METHOD] = "bound_method",
+  [OBJ_MODULE] = "module",
+  [OBJ_SET] = "set",
+  [OBJ_PRIORITY_QUEUE] = "priority_queue",
+  [OBJ_FLOAT_ARRAY] = "float_array",
+  [OBJ_RANGE] = "range",
+  [OBJ_SEQUENCE] = "sequence",
+  [OBJ_STRING_BUILDER] = "string_builder",
+  [OBJ_BYTES] = "bytes",
+};
+
+static void* allocateArray(size_t count, size_t size) {
+  return rawReallocate(NULL, 0, count == 0 ? size : count * size);
+}
+
+static void freeArray(void* pointer, size_t count, size_t size) {
+  rawReallocate(pointer, count == 0 ? size : count * size, 0);
+}
+
+static int compareObjects(const void* left, const void* right) {
+  uintptr_t a = (uintptr_t)*(Obj* const*)left;
+  uintptr_t b = (uintptr_t)*(Obj* const*)right;
+  return (a > b) - (a < b);
+}
+
+static int nodeFor(HeapGraph* graph, Obj* object) {
+  int low = 0;
+  int high = graph->nodeCount - 2;
+  while (low <= high) {
+    int middle = low + (high - low) / 2;
+    if (graph->objects[middle] == object) return middle + 1;
+    if ((uintptr_t)graph->objects[middle] < (uintptr_t)object) {
+      low = middle + 1;
+    } else {
+      high = middle - 1;
+    }
+  }
+  return -1;
+}
+
+static void addEdge(Obj* object, void* context) {
+  HeapGraph* graph = (HeapGraph*)context;
+  int node = nodeFor(graph, object);
+  if (node < 0 || graph->failed) return;
+
+  if (graph->edgeCount == graph->edgeCapacity) {
+    int capacity = GROW_CAPACITY(graph->edgeCapacity);
+    int* edges = (int*)rawReallocate(graph->edges,
+                                     sizeof(int) * (size_t)graph->edgeCapacity,
+                                     sizeof(int) * (size_t)capacity);
+    if (edges == NULL) {
+      graph->failed = true;
+      return;
+    }
+    graph->edges = edges;
+    graph->edgeCapacity = capacity;
+  }
+  graph->edges[graph->edgeCount++] = node;
+}
+
+static void freeGraph(HeapGraph* graph) {
+  int objectCount = graph->nodeCount - 1;
+  freeArray(graph->objects, (size_t)objectCount, sizeof(Obj*));
+  freeArray(graph->sizes, (size_t)graph->nodeCount, sizeof(size_t));
+  freeArray(graph->edgeStart, (size_t)graph->nodeCount + 1, sizeof(int));
+  rawReallocate(graph->edges, sizeof(int) * (size_t)graph->edgeCapacity, 0);
+}
+
+static bool buildGraph(HeapGraph* graph) {
+  int objectCount = 0;
+  for (ObjPage* page = vm.pages; page != NULL; page = page->next) {
+    for (uint32_t i = 0; i < page->slotCount; i++) {
+      if (PAGE_SLOT(page, i)->type != OBJ_FREE) objectCount++;
+    }
+  }
+
+  graph->nodeCount = objectCount + 1;
+  graph->objects = (Obj**)allocateArray((size_t)objectCount, sizeof(Obj*));
+  graph->sizes = (size_t*)allocateArray((size_t)graph->nodeCount, sizeof(size_t));
+  graph->edgeStart = (int*)allocateArray((size_t)graph->nodeCount + 1, sizeof(int));
+  if (graph->objects == NULL || graph->sizes == NULL || graph->edgeStart == NULL) {
+    return false;
+  }
+
+  int count = 0;
+  for (ObjPage* page = vm.pages; page != NULL; page = page->next) {
+    for (uint32_t i = 0; i < page->slotCount; i++) {
+      Obj* object = PAGE_SLOT(page, i);
+      if (object->type != OBJ_FREE) graph->objects[count++] = object;
+    }
+  }
+  qsort(graph->objects, (size_t)objectCount, sizeof(Obj*), compareObjects);
+
+  // slot sizes come from the owning page, so look them up after sorting
+  graph->sizes[0] = 0;
+  for (ObjPage* page = vm.pages; page != NULL; page = page->next) {
+    for (uint32_t i = 0; i < page->slotCount; i++) {
+      Obj* object = PAGE_SLOT(page, i);
+      if (object->type == OBJ_FREE) continue;
+      graph->sizes[nodeFor(graph, object)] = page->slotSize + objectOwnedBytes(object);
+    }
+  }
+
+  graph->edgeStart[0] = 0;
+  visitRoots(addEdge, graph);
+  for (int node = 1; node < graph->nodeCount; node++) {
+    graph->edgeStart[node] = graph->edgeCount;
+    visitReferences(graph->objects[node - 1], addEdge, graph);
+  }
+  graph->edgeStart[graph->nodeCount] = graph->edgeCount;
+  return !graph->failed;
+}
+
+static int intersect(int* dominators, int* postorder, int left, int right) {
+  while (left != right) {
+    while (postorder[left] < postorder[right]) left = dominators[left];
+    while (postorder[right] < postorder[left]) right = dominators[right];
+  }
+  return left;
+}
+
+// Cooper, Harvey and Kennedy's iterative algorithm over the reverse postorder
+// of a depth-first walk from the root; unreachable nodes keep -1
+static bool computeDominators(HeapGraph* graph, int* dominators, size_t* retained) {
+  int nodes = graph->nodeCount;
+  int* postorder = (int*)allocateArray((size_t)nodes, sizeof(int));
+  int* order = (int*)allocateArray((size_t)nodes, sizeof(int));
+  int* stack = (int*)allocateArray((size_t)nodes, sizeof(int));
+  int* cursor = (int*)allocateArray((size_t)nodes, sizeof(int));
+  int* predecessorStart = (int*)allocateArray((size_t)nodes + 1, sizeof(int));
+  int* predecessors = (int*)allocateArray((size_t)graph->edgeCount, sizeof(int));
+  bool ok = postorder != NULL && order != NULL && stack != NULL &&
+            cursor != NULL && predecessorStart != NULL && predecessors != NULL;
+
+  if (ok) {
+    for (int i = 0; i < nodes; i++) {
+      postorder[i] = -1;
+      cursor[i] = graph->edgeStart[i];
+      dominators[i] = -1;
+    }
+
+    int visited = 0;
+    int depth = 0;
+    stack[depth++] = 0;
+    postorder[0] = -2;
+    while (depth > 0) {
+      int node = stack[depth - 1];
+      if (cursor[node] < graph->edgeStart[node + 1]) {
+        int next = graph->edges[cursor[node]++];
+        if (postorder[next] == -1) {
+          postorder[next] = -2;
+          stack[depth++] = next;
+        }
+        continue;
+      }
+      depth--;
+      postorder[node] = visited;
+      order[visited++] = node;
+    }
+
+    memset(predecessorStart, 0, sizeof(int) * ((size_t)nodes + 1));
+    for (int i = 0; i < graph->edgeCount; i++) predecessorStart[graph->edges[i] + 1]++;
+    for (int i = 0; i < nodes; i++) predecessorStart[i + 1] += predecessorStart[i];
+    for (int i = 0; i < nodes; i++) cursor[i] = predecessorStart[i];
+    for (int node = 0; node < nodes; node++) {
+      for (int i = graph->edgeStart[node]; i < graph->edgeStart[node + 1]; i++) {
+        predecessors[cursor[graph->edges[i]]++] = node;
+      }
+    }
+
+    dominators[0] = 0;
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (int i = visited - 2; i >= 0; i--) {
+        int node = order[i];
+        int candidate = -1;
+        for (int j = predecessorStart[node]; j < predecessorStart[node + 1]; j++) {
+          int predecessor = predecessors[j];
+          if (dominators[predecessor] == -1) continue;
+          candidate = candidate == -1
+                          ? predecessor
+                          : intersect(dominators, postorder, predecessor, candidate);
+        }
+        if (candidate != dominators[node]) {
+          dominators[node] = candidate;
+          changed = true;
+        }
+      }
+    }
+
+    // children precede their dominator in postorder
+    for (int i = 0; i < nodes; i++) retained[i] = graph->sizes[i];
+    for (int i = 0; i < visited - 1; i++) {
+      int node = order[i];
+      retained[dominators[node]] += retained[node];
+    }
+  }
+
+  freeArray(postorder, (size_t)nodes, sizeof(int));
+  freeArray(order, (size_t)nodes, sizeof(int));
+  freeArray(stack, (size_t)nodes, sizeof(int));
+  freeArray(cursor, (size_t)nodes, sizeof(int));
+  freeArray(predecessorStart, (size_t)nodes + 1, sizeof(int));
+  freeArray(predecessors, (size_t)graph->edgeCount, sizeof(int));
+  return ok;
+}
+
+static void emit(SnapshotWriter* writer, const char* format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < 0) return;
+  if ((size_t)length >= sizeof(buffer)) length = (int)sizeof(buffer) - 1;
+  writer->write(activeVM, buffer, (size_t)length, writer->userData);
+}
+
+static void emitLabel(SnapshotWriter* writer, ObjString* label) {
+  if (label == NULL) return;
+  emit(writer, ",\"label\":\"");
+  int length = label->length < 32 ? label->length : 32;
+  for (int i = 0; i < length; i++) {
+    unsigned char c = (unsigned char)label->chars[i];
+    if (c == '"' || c == '\\') {
+      emit(writer, "\\%c", c);
+    } else if (c < 0x20 || c >= 0x7f) {
+      emit(writer, "\\u%04x", c);
+    } else {
+      emit(writer, "%c", c);
+    }
+  }
+  emit(writer, label->length > 32 ? "...\"" : "\"");
+}
+
+static ObjString* labelFor(Obj* object) {
+  switch (object->type) {
+    case OBJ_STRING: return (ObjString*)object;
+    case OBJ_FUNCTION: return ((ObjFunction*)object)->name;
+    case OBJ_CLOSURE: return ((ObjClosure*)object)->function->name;
+    case OBJ_CLASS: return ((ObjClass*)object)->name;
+    case OBJ_INSTANCE: return ((ObjInstance*)object)->klass->name;
+    case OBJ_BOUND_METHOD: return ((ObjBoundMethod*)object)->method->function->name;
+    case OBJ_MODULE: return ((ObjModule*)object)->name;
+    default: return NULL;
+  }
+}
+
+static void writeGraph(SnapshotWriter* writer, HeapGraph* graph,
+                       int* dominators, size_t* retained) {
+  emit(writer, "{\"snapshot\":1,\"objects\":%d,\"edges\":%d,\"bytes\":%zu}\n",
+       graph->nodeCount - 1, graph->edgeCount, retained[0]);
+
+  for (int node = 0; node < graph->nodeCount; node++) {
+    Obj* object = node == 0 ? NULL : graph->objects[node - 1];
+    emit(writer, "{\"id\":%d,\"type\":\"%s\",\"size\":%zu,\"retained\":%zu,"
+                 "\"dominator\":%d,\"refs\":[",
+         node, object == NULL ? "root" : typeNames[object->type],
+         graph->sizes[node], retained[node], dominators[node]);
+    for (int i = graph->edgeStart[node]; i < graph->edgeStart[node + 1]; i++) {
+      emit(writer, i == graph->edgeStart[node] ? "%d" : ",%d", graph->edges[i]);
+    }
+    emit(writer, "]");
+    if (object != NULL) emitLabel(writer, labelFor(object));
+    emit(writer, "}\n");
+  }
+}
+
+PB_API bool pbWriteHeapSnapshot(PbVM *instance, PbWriteFn write, void *userData)
+{
+  if (instance == NULL || write == NULL) return false;
+  VM* previous = activeVM;
+  activeVM = instance;
+
+  // only reachable objects are interesting, and collecting first means the
+  // graph has no stragglers waiting for the next sweep
+  if (!vm.hadRuntimeError) collectGarbage();
+
+  HeapGraph graph = {0};
+  SnapshotWriter writer = {write, userData};
+  bool ok = buildGraph(&graph);
+  int* dominators = NULL;
+  size_t* retained = NULL;
+  if (ok) {
+    dominators = (int*)allocateArray((size_t)graph.nodeCount, sizeof(int));
+    retained = (size_t*)allocateArray((size_t)graph.nodeCount, sizeof(size_t));
+    ok = dominators != NULL && retained != NULL &&
+         computeDominators(&graph, dominators, retained);
+  }
+  if (ok) writeGraph(&writer, &graph, dominators, retained);
+
+  freeArray(dominators, (size_t)graph.nodeCount, sizeof(int));
+  freeArray(retained, (size_t)graph.nodeCount, sizeof(size_t));
+  freeGraph(&graph);
+  activeVM = previous;
+  return ok;
+}
@@ -0,0 +1,291 @@
+#include <string.h>
+
+#include "headers/memory.h"
+#include "headers/object.h"
+#include "headers/sort.h"
+
+// below this many elements a pass over every key costs more than it saves
+#define INSERTION_SORT_MAX 32
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+
+// Numbers are sorted by a radix sort over their bit patterns, mapped so that
+// unsigned order matches numeric order: negative numbers have every bit
+// flipped, the rest just the sign bit. -0 takes the key of 0, since the two
+// are equal, and NaNs end up beyond the infinities of their sign. Each key
+// remembers where its number started, so only the keys move while sorting
+// and the values are copied back as they were.
+
+static inline uint64_t numberKey(double number) {
+  if (number == 0) number = 0.0;
+  uint64_t bits;
+  memcpy(&bits, &number, sizeof(bits));
+  return (bits & 0x8000000000000000u) ? ~bits : bits | 0x8000000000000000u;
+}
+
+typedef struct {
+  uint64_t key;
+  int index;
+} IndexedKey;
+
+// a least-significant-digit radix sort, which returns whichever of the two
+// buffers ends up holding the sorted keys. Each pass is stable, so equal keys
+// keep their order
+static IndexedKey* radixSortKeys(IndexedKey* keys, IndexedKey* scratch,
+                                 int count) {
+  int counts[RADIX_PASSES][RADIX_BUCKETS] = {{0}};
+  for (int i = 0; i < count; i++) {
+    for (int pass = 0; pass < RADIX_PASSES; pass++) {
+      counts[pass][(keys[i].key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+  }
+
+  for (int pass = 0; pass < RADIX_PASSES; pass++) {
+    int shift = pass * RADIX_BITS;
+    int* bucket = counts[pass];
+    // a digit every key shares leaves the order as it is
+    if (bucket[(keys[0].key >> shift) & (RADIX_BUCKETS - 1)] == count) continue;
+
+    int offset = 0;
+    for (int digit = 0; digit < RADIX_BUCKETS; digit++) {
+      int size = bucket[digit];
+      bucket[digit] = offset;
+      offset += size;
+    }
+    for (int i = 0; i < count; i++) {
+      scratch[bucket[(keys[i].key >> shift) & (RADIX_BUCKETS - 1)]++] = keys[i];
+    }
+
+    IndexedKey* sorted = scratch;
+    scratch = keys;
+    keys = sorted;
+  }
+  return keys;
+}
+
+static void insertionSortKeys(IndexedKey* keys, int count) {
+  for (int i = 1; i < count; i++) {
+    IndexedKey key = keys[i];
+    int j = i;
+    for (; j > 0 && keys[j - 1].key > key.key; j--) keys[j] = keys[j - 1];
+    keys[j] = key;
+  }
+}
+
+// keys has room for twice count; returns whichever half holds them sorted.
+// Flipping every key turns ascending order into descending order, and the
+// stable passes still keep equal numbers as they were
+static IndexedKey* sortNumberKeys(Value* numbers, int count, bool descending,
+                                  IndexedKey* keys) {
+  for (int i = 0; i < count; i++) {
+    uint64_t key = numberKey(AS_NUMBER(numbers[i]));
+    keys[i].key = descending ? ~key : key;
+    keys[i].index = i;
+  }
+
+  if (count <= INSERTION_SORT_MAX) {
+    insertionSortKeys(keys, count);
+    return keys;
+  }
+  return radixSortKeys(keys, keys + count, count);
+}
+
+void sortNumbers(Value* values, int count) {
+  if (count < 2) return;
+
+  // a list that is already in order is left exactly as it is
+  uint64_t previous = numberKey(AS_NUMBER(values[0]));
+  int ordered = 1;
+  while (ordered < count) {
+    uint64_t key = numberKey(AS_NUMBER(values[ordered]));
+    if (key < previous) break;
+    previous = key;
+    ordered++;
+  }
+  if (ordered == count) return;
+
+  IndexedKey* keys = ALLOCATE(IndexedKey, (size_t)count * 2);
+  if (keys == NULL) return;
+  Value* sortedValues = ALLOCATE(Value, count);
+  if (sortedValues == NULL) {
+    FREE_ARRAY(IndexedKey, keys, (size_t)count * 2);
+    return;
+  }
+
+  IndexedKey* sorted = sortNumberKeys(values, count, false, keys);
+  for (int i = 0; i < count; i++) sortedValues[i] = values[sorted[i].index];
+  memcpy(values, sortedValues, sizeof(Value) * (size_t)count);
+  FREE_ARRAY(Value, sortedValues, count);
+  FREE_ARRAY(IndexedKey, keys, (size_t)count * 2);
+}
+
+static bool orderNumbers(Value* keys, int count, bool descending, int* order) {
+  IndexedKey* indexed = ALLOCATE(IndexedKey, (size_t)count * 2);
+  if (indexed == NULL) return false;
+  IndexedKey* sorted = sortNumberKeys(keys, count, descending, indexed);
+  for (int i = 0; i < count; i++) order[i] = sorted[i].index;
+  FREE_ARRAY(IndexedKey, indexed, (size_t)count * 2);
+  return true;
+}
+
+// Strings are merge sorted, which is stable and has no bad inputs. Each one
+// carries eight bytes as a big-endian integer, taken after the prefix that
+// every string in the list shares, so most comparisons are a single integer
+// compare that never touches the characters.
+
+typedef struct {
+  uint64_t prefix;
+  ObjString* string;
+  int index;
+} StringKey;
+
+typedef struct {
+  int shared;      // leading bytes common to every string
+  bool descending;
+} StringOrder;
+
+static int sharedPrefix(Value* values, int count) {
+  ObjString* first = AS_STRING(values[0]);
+  int shared = first->length;
+  for (int i = 1; i < count && shared > 0; i++) {
+    ObjString* string = AS_STRING(values[i]);
+    if (string->length < shared) shared = string->length;
+    int same = 0;
+    while (same < shared && string->chars[same] == first->chars[same]) same++;
+    shared = same;
+  }
+  return shared;
+}
+
+static inline uint64_t stringPrefix(ObjString* string, int shared) {
+  uint64_t prefix = 0;
+  int length = string->length - shared < 8 ? string->length - shared : 8;
+  for (int i = 0; i < 8; i++) {
+    prefix <<= 8;
+    if (i < length) prefix |= (uint8_t)string->chars[shared + i];
+  }
+  return prefix;
+}
+
+// byte-wise order; a string sorts after every proper prefix of itself
+static inline bool stringKeyLess(const StringKey* left, const StringKey* right,
+                                 int shared) {
+  if (left->prefix != right->prefix) return left->prefix < right->prefix;
+  if (left->string == right->string) return false;
+
+  // equal prefixes mean the shared bytes and up to eight more match
+  int shorter = left->string->length < right->string->length
+                    ? left->string->length
+                    : right->string->length;
+  int start = shorter - shared < 8 ? shorter : shared + 8;
+  int result = memcmp(left->string->chars + start, right->string->chars + start,
+                      (size_t)(shorter - start));
+  if (result != 0) return result < 0;
+  return left->string->length < right->string->length;
+}
+
+// whether left must come before right; equal strings never do, which is what
+// keeps both directions stable
+static inline bool stringKeyBefore(const StringKey* left, const StringKey* right,
+                                   const StringOrder* order) {
+  return order->descending ? stringKeyLess(right, left, order->shared)
+                           : stringKeyLess(left, right, order->shared);
+}
+
+#define MERGE_RUN 16
+
+static void insertionSortStrings(StringKey* keys, int count,
+                                 const StringOrder* order) {
+  for (int i = 1; i < count; i++) {
+    StringKey key = keys[i];
+    int j = i;
+    for (; j > 0 && stringKeyBefore(&key, &keys[j - 1], order); j--) {
+      keys[j] = keys[j - 1];
+    }
+    keys[j] = key;
+  }
+}
+
+static void mergeRuns(const StringKey* from, StringKey* to, int start,
+                      int middle, int end, const StringOrder* order) {
+  // runs that already follow each other need no merge
+  if (!stringKeyBefore(&from[middle], &from[middle - 1], order)) {
+    memcpy(to + start, from + start, sizeof(StringKey) * (size_t)(end - start));
+    return;
+  }
+
+  int left = start;
+  int right = middle;
+  for (int i = start; i < end; i++) {
+    if (left < middle &&
+        (right == end || !stringKeyBefore(&from[right], &from[left], order))) {
+      to[i] = from[left++];
+    } else {
+      to[i] = from[right++];
+    }
+  }
+}
+
+// keys has room for twice count; returns whichever half holds the sorted run
+static StringKey* mergeSortStrings(Value* values, int count, StringKey* keys,
+                                   bool descending) {
+  StringOrder order = {sharedPrefix(values, count), descending};
+  for (int i = 0; i < count; i++) {
+    keys[i].string = AS_STRING(values[i]);
+    keys[i].prefix = stringPrefix(keys[i].string, order.shared);
+    keys[i].index = i;
+  }
+
+  for (int start = 0; start < count; start += MERGE_RUN) {
+    int size = count - start < MERGE_RUN ? count - start : MERGE_RUN;
+    insertionSortStrings(keys + start, size, &order);
+  }
+
+  StringKey* from = keys;
+  StringKey* to = keys + count;
+  for (int width = MERGE_RUN; width < count; width *= 2) {
+    for (int start = 0; start < count; start += 2 * width) {
+      int middle = start + width < count ? start + width : count;
+      int end = start + 2 * width < count ? start + 2 * width : count;
+      if (middle == end) {
+        memcpy(to + start, from + start, sizeof(StringKey) * (size_t)(end - start));
+      } else {
+        mergeRuns(from, to, start, middle, end, &order);
+      }
+    }
+    StringKey* merged = to;
+    to = from;
+    from = merged;
+  }
+  return from;
+}
+
+void sortStrings(Value* values, int count) {
+  if (count < 2) return;
+
+  StringKey* keys = ALLOCATE(StringKey, (size_t)count * 2);
+  if (keys == NULL) return;
+  StringKey* sorted = mergeSortStrings(values, count, keys, false);
+  for (int i = 0; i < count; i++) values[i] = OBJ_VAL(sorted[i].string);
+  FREE_ARRAY(StringKey, keys, (size_t)count * 2);
+}
+
+static bool orderStrings(Value* keys, int count, bool descending, int* order) {
+  StringKey* stringKeys = ALLOCATE(StringKey, (size_t)count * 2);
+  if (stringKeys == NULL) return false;
+  StringKey* sorted = mergeSortStrings(keys, count, stringKeys, descending);
+  for (int i = 0; i < count; i++) order[i] = sorted[i].index;
+  FREE_ARRAY(StringKey, stringKeys, (size_t)count * 2);
+  return true;
+}
+
+bool sortOrder(Value* keys, int count, bool descending, int* order) {
+  if (count == 0) return true;
+  if (count == 1) {
+    order[0] = 0;
+    return true;
+  }
+  if (IS_NUMBER(keys[0])) return orderNumbers(keys, count, descending, order);
+  return orderStrings(keys, count, descending, order);
+}
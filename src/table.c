@@ -1,116 +1,253 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TABLE_USE_SSE2
+#endif
+
 #include "headers/memory.h"
 #include "headers/object.h"
 #include "headers/table.h"
 #include "headers/value.h"
 
-#define TABLE_MAX_LOAD 0.75
+// control bytes: full slots hold the low 7 bits of the hash (high bit clear),
+// free ones have the high bit set
+#define CONTROL_EMPTY 0x80
+#define CONTROL_DELETED 0xfe
+
+#define TABLE_MIN_CAPACITY 8
 
 void initTable(Table* table) {
   table->count = 0;
   table->capacity = 0;
-  table->entries = NULL;
+  table->growthLeft = 0;
+  table->values = NULL;
+  table->keys = NULL;
+  table->control = NULL;
+}
+
+// tables smaller than a group still get a full group of control bytes so
+// every load is 16 bytes; the padding reads as empty but is masked off
+static size_t controlBytes(int capacity) {
+  return capacity < TABLE_GROUP_WIDTH ? TABLE_GROUP_WIDTH : (size_t)capacity;
+}
+
+static size_t storageBytes(int capacity) {
+  if (capacity == 0) return 0;
+  return (size_t)capacity * (sizeof(Value) + sizeof(ObjString*)) +
+         controlBytes(capacity);
+}
+
+size_t tableBytes(Table* table) {
+  return storageBytes(table->capacity);
 }
 
 void freeTable(Table* table) {
-  FREE_ARRAY(Entry, table->entries, table->capacity);
+  FREE_ARRAY(char, table->values, storageBytes(table->capacity));
   initTable(table);
 }
 
-static Entry* findEntry(Entry* entries, int capacity, ObjString* key) {
-  uint32_t index = key->hash & (capacity - 1); // replacing modulo with a bitwise operator makes it MUCH faster
-  Entry* tombstone = NULL;
-
-  for (;;) {
-    Entry* entry = &entries[index];
-    if (entry->key == NULL) {
-      // return tombstone's bucket if we've passed one before, otherwise return the empty bucket when searching
-    if (IS_NIL(entry->value)) {
-      // empty entry
-      return tombstone != NULL ? tombstone : entry; // here we end up reusing tombstones if they are at the end of a chunk of same hashes
-    } else {
-      // found a tombstone
-      if (tombstone == NULL) tombstone = entry;
+
+static uint32_t validSlots(int capacity) {
+  return capacity < TABLE_GROUP_WIDTH ? (1u << capacity) - 1 : 0xffffu;
+}
+
+static int growthLimit(int capacity) {
+  return capacity - capacity / 8; // 7/8 maximum load
+}
+
+static inline int lowestBit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int bit = 0;
+  while ((mask & 1) == 0) {
+    mask >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+// bit i is set when control[i] == byte
+static inline uint32_t matchByte(const uint8_t* control, uint8_t byte) {
+#ifdef TABLE_USE_SSE2
+  __m128i group = _mm_loadu_si128((const __m128i*)control);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)byte)));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < TABLE_GROUP_WIDTH; i++) {
+    if (control[i] == byte) mask |= 1u << i;
+  }
+  return mask;
+#endif
+}
+
+// bit i is set when control[i] is empty or deleted
+static inline uint32_t matchFree(const uint8_t* control) {
+#ifdef TABLE_USE_SSE2
+  return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)control));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < TABLE_GROUP_WIDTH; i++) {
+    if (control[i] & 0x80) mask |= 1u << i;
+  }
+  return mask;
+#endif
+}
+
+static inline uint8_t hashFragment(uint32_t hash) {
+  return (uint8_t)(hash & 0x7f);
+}
+
+// groups are visited in triangular order, which covers every group of a
+// power-of-two table exactly once
+#define FOR_EACH_GROUP(table, hash, group)                                   \
+  for (int group##Mask_ = ((table)->capacity - 1) / TABLE_GROUP_WIDTH,      \
+           group = (int)((hash) >> 7) & group##Mask_, group##Step_ = 1;      \
+       ; group = (group + group##Step_++) & group##Mask_)
+
+static inline int findSlot(Table* table, ObjString* key) {
+  uint8_t fragment = hashFragment(key->hash);
+  uint32_t valid = validSlots(table->capacity);
+
+  FOR_EACH_GROUP(table, key->hash, group) {
+    const uint8_t* control = table->control + group * TABLE_GROUP_WIDTH;
+    uint32_t matches = matchByte(control, fragment) & valid;
+    while (matches != 0) {
+      int slot = group * TABLE_GROUP_WIDTH + lowestBit(matches);
+      if (table->keys[slot] == key) return slot;
+      matches &= matches - 1;
     }
-  } else if (entry->key == key) {
-    return entry;
+    if ((matchByte(control, CONTROL_EMPTY) & valid) != 0) return -1;
   }
+}
 
-    index = (index + 1) & (capacity - 1); // linear probing
+// like findSlot, but also reports the first empty or deleted slot on the
+// key's probe sequence so an insert does not have to probe twice
+static int findSlotForInsert(Table* table, ObjString* key, int* freeSlot) {
+  uint8_t fragment = hashFragment(key->hash);
+  uint32_t valid = validSlots(table->capacity);
+  *freeSlot = -1;
+
+  FOR_EACH_GROUP(table, key->hash, group) {
+    const uint8_t* control = table->control + group * TABLE_GROUP_WIDTH;
+    uint32_t matches = matchByte(control, fragment) & valid;
+    while (matches != 0) {
+      int slot = group * TABLE_GROUP_WIDTH + lowestBit(matches);
+      if (table->keys[slot] == key) return slot;
+      matches &= matches - 1;
+    }
+    if (*freeSlot < 0) {
+      uint32_t freeSlots = matchFree(control) & valid;
+      if (freeSlots != 0) *freeSlot = group * TABLE_GROUP_WIDTH + lowestBit(freeSlots);
+    }
+    if ((matchByte(control, CONTROL_EMPTY) & valid) != 0) return -1;
   }
 }
 
-static void adjustCapacity(Table* table, int capacity) {
-  Entry* entries = ALLOCATE(Entry, capacity);
-  for (int i = 0; i < capacity; i++) {
-    entries[i].key = NULL;
-    entries[i].value = NIL_VAL;
+static int findFreeSlot(Table* table, uint32_t hash) {
+  uint32_t valid = validSlots(table->capacity);
+  FOR_EACH_GROUP(table, hash, group) {
+    uint32_t freeSlots = matchFree(table->control + group * TABLE_GROUP_WIDTH) & valid;
+    if (freeSlots != 0) return group * TABLE_GROUP_WIDTH + lowestBit(freeSlots);
   }
+}
 
-  table->count = 0; // clearing this out as we will not copy over tombstones as they would only slow down lookups in a fresh array (we are rebuilding the probe sequence anyway)
+// leaves the table as it was when the new storage is refused
+static bool resize(Table* table, int capacity) {
+  char* storage = ALLOCATE(char, storageBytes(capacity));
+  if (storage == NULL) return false;
+  Table resized;
+  resized.count = table->count;
+  resized.capacity = capacity;
+  resized.growthLeft = growthLimit(capacity) - table->count;
+  resized.values = (Value*)storage;
+  resized.keys = (ObjString**)(storage + sizeof(Value) * (size_t)capacity);
+  resized.control = (uint8_t*)(resized.keys + capacity);
+  memset(resized.control, CONTROL_EMPTY, controlBytes(capacity));
 
-  // rebuild the table from scratch whenever size needs to be changed as the previous elements may end up in different indexes whenever capacity increases (index calcuated hash modulo size)
+  // deleted slots are not carried over, so a rehash also clears them out
   for (int i = 0; i < table->capacity; i++) {
-    Entry* entry = &table->entries[i];
-    if (entry->key == NULL) continue;
-
-    // new destination
-    Entry* dest = findEntry(entries, capacity, entry->key);
-    dest->key = entry->key;
-    dest->value = entry->value;
-    table->count++;
+    if (table->control[i] & 0x80) continue;
+    ObjString* key = table->keys[i];
+    int slot = findFreeSlot(&resized, key->hash);
+    resized.control[slot] = hashFragment(key->hash);
+    resized.keys[slot] = key;
+    resized.values[slot] = table->values[i];
   }
 
-  FREE_ARRAY(Entry, table->entries, table->capacity);
-  table->entries = entries;
-  table->capacity = capacity;  
+  FREE_ARRAY(char, table->values, storageBytes(table->capacity));
+  *table = resized;
+  return true;
 }
 
 bool tableGet(Table* table, ObjString* key, Value* value) {
   if (table->count == 0) return false;
 
-  Entry* entry = findEntry(table->entries, table->capacity, key);
-  if (entry->key == NULL) return false;
+  int slot = findSlot(table, key);
+  if (slot < 0) return false;
 
-  *value = entry->value;
+  *value = table->values[slot];
   return true;
 }
 
 bool tableSet(Table* table, ObjString* key, Value value) {
-  if (table->count + 1 > table->capacity * TABLE_MAX_LOAD) {
-    int capacity = GROW_CAPACITY(table->capacity);
-    adjustCapacity(table, capacity);
+  int freeSlot = -1;
+  int slot = table->capacity == 0 ? -1 : findSlotForInsert(table, key, &freeSlot);
+  if (slot >= 0) {
+    table->values[slot] = value;
+    return false;
+  }
+
+  // reusing a deleted slot costs no growth
+  slot = freeSlot;
+  if (slot < 0 || (table->control[slot] == CONTROL_EMPTY && table->growthLeft == 0)) {
+    // mostly tombstones: rebuild at the same size instead of doubling
+    int capacity = table->capacity == 0 ? TABLE_MIN_CAPACITY : table->capacity;
+    if (table->count + 1 > growthLimit(capacity) / 2) capacity *= 2;
+    if (!resize(table, capacity)) return false;
+    slot = findFreeSlot(table, key->hash);
   }
 
-  Entry* entry = findEntry(table->entries, table->capacity, key);
-  bool isNewKey = entry->key == NULL;
-  // increment count only if new value is inserted in a completely empty spot (non-tombstone)
-  if (isNewKey && IS_NIL(entry->value)) table->count++;
+  if (table->control[slot] == CONTROL_EMPTY) table->growthLeft--;
+  table->control[slot] = hashFragment(key->hash);
+  table->keys[slot] = key;
+  table->values[slot] = value;
+  table->count++;
+  return true;
+}
 
-  entry->key = key;
-  entry->value = value;
-  return isNewKey;
+static void clearSlot(Table* table, int slot) {
+  // a probe only moves past a group that has no empty slot, so when this
+  // group still has one the slot can go straight back to empty
+  const uint8_t* group = table->control + (slot & ~(TABLE_GROUP_WIDTH - 1));
+  if ((matchByte(group, CONTROL_EMPTY) & validSlots(table->capacity)) != 0) {
+    table->control[slot] = CONTROL_EMPTY;
+    table->growthLeft++;
+  } else {
+    table->control[slot] = CONTROL_DELETED;
+  }
+  table->keys[slot] = NULL;
+  table->values[slot] = NIL_VAL;
+  table->count--;
 }
 
 bool tableDelete(Table* table, ObjString* key) {
   if (table->count == 0) return false;
 
-  Entry* entry = findEntry(table->entries, table->capacity, key);
-  if (entry->key == NULL) return false;
+  int slot = findSlot(table, key);
+  if (slot < 0) return false;
 
-  // tombstone
-  entry->key = NULL;
-  entry->value = BOOL_VAL(true);
+  clearSlot(table, slot);
   return true;
 }
 
 void tableAddAll(Table* from, Table* to) {
   for (int i = 0; i < from->capacity; i++) {
-    Entry* entry = &from->entries[i];
-    if (entry->key != NULL) {
-      tableSet(to, entry->key, entry->value);
+    if (!(from->control[i] & 0x80)) {
+      tableSet(to, from->keys[i], from->values[i]);
     }
   }
 }
@@ -118,33 +255,76 @@ void tableAddAll(Table* from, Table* to) {
 ObjString* tableFindString(Table* table, const char* chars, int length, uint32_t hash) {
   if (table->count == 0) return NULL;
 
-  uint32_t index = hash & (table->capacity - 1);
-  for (;;) {
-    Entry* entry = &table->entries[index];
-    if (entry->key == NULL) {
-      // stop if we find an empty non-tombstone entry
-      if (IS_NIL(entry->value)) return NULL;
-    } else if (entry->key->length == length && entry->key->hash && memcmp(entry->key->chars, chars, length) == 0) {
-      return entry->key;
+  uint8_t fragment = hashFragment(hash);
+  uint32_t valid = validSlots(table->capacity);
+  FOR_EACH_GROUP(table, hash, group) {
+    const uint8_t* control = table->control + group * TABLE_GROUP_WIDTH;
+    uint32_t matches = matchByte(control, fragment) & valid;
+    while (matches != 0) {
+      ObjString* key = table->keys[group * TABLE_GROUP_WIDTH + lowestBit(matches)];
+      if (key->hash == hash && key->length == length &&
+          memcmp(key->chars, chars, (size_t)length) == 0) {
+        return key;
+      }
+      matches &= matches - 1;
     }
-
-    index = (index + 1) & (table->capacity - 1);
+    if ((matchByte(control, CONTROL_EMPTY) & valid) != 0) return NULL;
   }
 }
 
+static int tombstoneCount(Table* table) {
+  if (table->capacity == 0) return 0;
+  return growthLimit(table->capacity) - table->count - table->growthLeft;
+}
+
+// drops unmarked keys during a collection and leaves the table without
+// tombstones, shrinking it once it is mostly empty, so long sessions do not
+// carry the interning set of their busiest moment
 void tableRemoveWhite(Table* table) {
   for (int i = 0; i < table->capacity; i++) {
-    Entry* entry = &table->entries[i];
-    if (entry->key != NULL && !entry->key->obj.isMarked) {
-      tableDelete(table, entry->key);
+    if (!(table->control[i] & 0x80) && !table->keys[i]->obj.isMarked) {
+      clearSlot(table, i);
+    }
+  }
+  if (table->capacity == 0) return;
+
+  // shrink only well below the growth point so a table hovering around one
+  // size does not bounce between two
+  int capacity = TABLE_MIN_CAPACITY;
+  while (growthLimit(capacity) / 2 < table->count) capacity *= 2;
+  if (capacity <= table->capacity / 4) {
+    resize(table, capacity);
+  } else if (tombstoneCount(table) > 0) {
+    resize(table, table->capacity);
+  }
+}
+
+void tableGetStats(Table* table, TableStats* stats) {
+  stats->count = table->count;
+  stats->capacity = table->capacity;
+  stats->tombstones = tombstoneCount(table);
+  stats->maxProbe = 0;
+  stats->averageProbe = 0;
+
+  long totalProbe = 0;
+  for (int i = 0; i < table->capacity; i++) {
+    if (table->control[i] & 0x80) continue;
+    int target = i / TABLE_GROUP_WIDTH;
+    int probe = 1;
+    FOR_EACH_GROUP(table, table->keys[i]->hash, group) {
+      if (group == target) break;
+      probe++;
     }
+    totalProbe += probe;
+    if (probe > stats->maxProbe) stats->maxProbe = probe;
   }
+  if (table->count > 0) stats->averageProbe = (double)totalProbe / table->count;
 }
 
 void markTable(Table* table) {
   for (int i = 0; i < table->capacity; i++) {
-    Entry* entry = &table->entries[i];
-    markObject((Obj*)entry->key);
-    markValue(entry->value);
+    if (table->control[i] & 0x80) continue;
+    markObject((Obj*)table->keys[i]);
+    markValue(table->values[i]);
   }
-}
\ No newline at end of file
+}
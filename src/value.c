@@ -1,43 +1,47 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
+
 #include "headers/object.h"
 #include "headers/memory.h"
+#include "headers/number.h"
 #include "headers/value.h"
 #include "headers/vm.h"
-
-void initValueArray(ValueArray* array) {
-  array->values = NULL;
-  array->capacity = 0;
-  array->count = 0;
-}
-
-void writeValueArray(ValueArray* array, Value value) {
-  if (array->capacity < array->count + 1) {
-    int oldCapacity = array->capacity;
-    array->capacity = GROW_CAPACITY(oldCapacity);
-    array->values = GROW_ARRAY(Value, array->values, oldCapacity, array->capacity);
-  }
-
-  array->values[array->count] = value;
-  array->count++;
-}
-
+
+void initValueArray(ValueArray* array) {
+  array->values = NULL;
+  array->capacity = 0;
+  array->count = 0;
+}
+
+void writeValueArray(ValueArray* array, Value value) {
+  if (array->capacity < array->count + 1) {
+    int oldCapacity = array->capacity;
+    int capacity = GROW_CAPACITY(oldCapacity);
+    Value* values = GROW_ARRAY(Value, array->values, oldCapacity, capacity);
+    if (values == NULL) return;
+    array->values = values;
+    array->capacity = capacity;
+  }
+
+  array->values[array->count] = value;
+  array->count++;
+}
+
 void freeValueArray(ValueArray* array) {
-  FREE_ARRAY(Value, array->values, array->capacity);
-  initValueArray(array);
-}
-
+  FREE_ARRAY(Value, array->values, array->capacity);
+  initValueArray(array);
+}
+
 void printValue(Value value) {
   ObjString* rendered = valueToString(value);
   fwrite(rendered->chars, sizeof(char), (size_t)rendered->length, stdout);
 }
-
-static bool stringsEqual(ObjString* left, ObjString* right) {
-  return left->length == right->length && memcmp(left->chars, right->chars, (size_t)left->length) == 0;
-}
-
+
+static bool stringsEqual(ObjString* left, ObjString* right) {
+  return left->length == right->length && memcmp(left->chars, right->chars, (size_t)left->length) == 0;
+}
+
 #define EQUALITY_MAX_DEPTH 256
 
 typedef struct {
@@ -104,63 +108,102 @@ static bool hashmapsEqual(ObjHashmap* left, ObjHashmap* right, EqualityContext*
   return equal;
 }
 
+// set elements are scalars, so membership is all equality needs
+static bool setsEqual(ObjSet* left, ObjSet* right) {
+  if (setCount(&left->items) != setCount(&right->items)) return false;
+
+  for (int position = setNextKey(&left->items, -1); position != -1;
+       position = setNextKey(&left->items, position)) {
+    if (!setHas(&right->items, SET_KEY_AT(&left->items, position))) return false;
+  }
+  return true;
+}
+
+static bool floatArraysEqual(ObjFloatArray* left, ObjFloatArray* right) {
+  if (left->count != right->count) return false;
+  for (int i = 0; i < left->count; i++) {
+    if (left->values[i] != right->values[i]) return false;
+  }
+  return true;
+}
+
+static bool rangesEqual(ObjRange* left, ObjRange* right) {
+  return left->start == right->start && left->end == right->end &&
+         left->step == right->step;
+}
+
 static bool objectsEqual(Value left, Value right, EqualityContext* context) {
-  Obj* leftObject = AS_OBJ(left);
-  Obj* rightObject = AS_OBJ(right);
-
-  if (leftObject == rightObject) return true;
-  if (leftObject->type != rightObject->type) return false;
-
-  switch (leftObject->type) {
-    case OBJ_STRING:
-      return stringsEqual((ObjString*)leftObject, (ObjString*)rightObject);
-
+  Obj* leftObject = AS_OBJ(left);
+  Obj* rightObject = AS_OBJ(right);
+
+  if (leftObject == rightObject) return true;
+  if (leftObject->type != rightObject->type) return false;
+
+  switch (leftObject->type) {
+    case OBJ_STRING:
+      return stringsEqual((ObjString*)leftObject, (ObjString*)rightObject);
+
     case OBJ_LIST:
       return listsEqual((ObjList*)leftObject, (ObjList*)rightObject, context);
-    
+    
     case OBJ_HASHMAP:
       return hashmapsEqual((ObjHashmap*)leftObject, (ObjHashmap*)rightObject, context);
-    
-    default:
-      return false;
-  }
-}
-
+
+    case OBJ_SET:
+      return setsEqual((ObjSet*)leftObject, (ObjSet*)rightObject);
+
+    case OBJ_FLOAT_ARRAY:
+      return floatArraysEqual((ObjFloatArray*)leftObject, (ObjFloatArray*)rightObject);
+
+    case OBJ_RANGE:
+      return rangesEqual((ObjRange*)leftObject, (ObjRange*)rightObject);
+
+    case OBJ_BYTES:
+      return ((ObjBytes*)leftObject)->string == ((ObjBytes*)rightObject)->string;
+
+    default:
+      return false;
+  }
+}
+
 static bool valuesEqualInternal(Value left, Value right, EqualityContext* context) {
-  if (left.type != right.type) return false;
-
-  switch (left.type) {
-    case VAL_BOOL:
-      return AS_BOOL(left) == AS_BOOL(right);
-    
-    case VAL_NUMBER:
-      return AS_NUMBER(left) == AS_NUMBER(right);
-
-    case VAL_NIL:
-      return true;
-    
+  if (left.type != right.type) return false;
+
+  switch (left.type) {
+    case VAL_BOOL:
+      return AS_BOOL(left) == AS_BOOL(right);
+    
+    case VAL_NUMBER:
+      return AS_NUMBER(left) == AS_NUMBER(right);
+
+    case VAL_NIL:
+      return true;
+    
     case VAL_OBJ:
       return objectsEqual(left, right, context);
-  }
-
-  return false;
-}
+  }
 
-typedef struct {
-  char* chars;
-  int count;
-  int capacity;
-  Obj** active;
-  int activeCount;
-  int activeCapacity;
-} StringBuilder;
+  return false;
+}
 
-static void appendChars(StringBuilder* builder, const char* chars, int length) {
+void appendChars(StringBuilder* builder, const char* chars, int length) {
   if (builder->count + length + 1 > builder->capacity) {
     int capacity = builder->capacity < 8 ? 8 : builder->capacity;
     while (builder->count + length + 1 > capacity) capacity *= 2;
-    char* charsBuffer = (char*)realloc(builder->chars, (size_t)capacity);
-    if (charsBuffer == NULL) exit(1);
+    char* charsBuffer;
+    if (builder->counted) {
+      charsBuffer = GROW_ARRAY(char, builder->chars, builder->capacity, capacity);
+    } else {
+      charsBuffer = (char*)rawReallocate(builder->chars,
+                                         (size_t)builder->capacity,
+                                         (size_t)capacity);
+      if (charsBuffer == NULL) {
+        runtimeError("Out of memory: the allocator could not provide %d bytes.",
+                     capacity);
+      }
+    }
+    // the text is cut short; the error ends the script
+    if (charsBuffer == NULL) return;
     builder->chars = charsBuffer;
     builder->capacity = capacity;
   }
@@ -186,19 +229,26 @@ bool valuesEqual(Value left, Value right) {
   return valuesEqualInternal(left, right, &context);
 }
 
-static void pushActive(StringBuilder* builder, Obj* object) {
+static bool pushActive(StringBuilder* builder, Obj* object) {
   if (builder->activeCount == builder->activeCapacity) {
     int capacity = builder->activeCapacity < 8 ? 8 : builder->activeCapacity * 2;
-    Obj** active = (Obj**)realloc(builder->active, sizeof(Obj*) * (size_t)capacity);
-    if (active == NULL) exit(1);
+    Obj** active = (Obj**)rawReallocate(builder->active,
+                                        sizeof(Obj*) * (size_t)builder->activeCapacity,
+                                        sizeof(Obj*) * (size_t)capacity);
+    if (active == NULL) {
+      runtimeError("Out of memory: the allocator could not provide %zu bytes.",
+                   sizeof(Obj*) * (size_t)capacity);
+      return false;
+    }
     builder->active = active;
     builder->activeCapacity = capacity;
   }
   builder->active[builder->activeCount++] = object;
+  return true;
 }
 
-static void appendValue(StringBuilder* builder, Value value) {
-  char number[32];
+void appendValue(StringBuilder* builder, Value value) {
+  char number[NUMBER_BUFFER_SIZE];
 
   switch (value.type) {
     case VAL_BOOL:
@@ -208,8 +258,7 @@ static void appendValue(StringBuilder* builder, Value value) {
       appendCString(builder, "nil");
       return;
     case VAL_NUMBER:
-      snprintf(number, sizeof(number), "%g", AS_NUMBER(value));
-      appendCString(builder, number);
+      appendChars(builder, number, formatNumber(AS_NUMBER(value), number));
       return;
     case VAL_OBJ:
       break;
@@ -226,7 +275,7 @@ static void appendValue(StringBuilder* builder, Value value) {
       appendCString(builder, "<cycle>");
       return;
     }
-    pushActive(builder, object);
+    if (!pushActive(builder, object)) return;
     ObjList* list = AS_LIST(value);
     appendCString(builder, "[");
     for (int i = 0; i < list->items.count; i++) {
@@ -243,7 +292,7 @@ static void appendValue(StringBuilder* builder, Value value) {
       appendCString(builder, "<cycle>");
       return;
     }
-    pushActive(builder, object);
+    if (!pushActive(builder, object)) return;
     ObjHashmap* map = AS_HASHMAP(value);
     appendCString(builder, "{");
     bool first = true;
@@ -261,6 +310,20 @@ static void appendValue(StringBuilder* builder, Value value) {
     return;
   }
 
+  if (object->type == OBJ_SET) {
+    Set* set = &AS_SET(value)->items;
+    appendCString(builder, "Set{");
+    bool first = true;
+    for (int position = setNextKey(set, -1); position != -1;
+         position = setNextKey(set, position)) {
+      if (!first) appendCString(builder, ", ");
+      first = false;
+      appendValue(builder, SET_KEY_AT(set, position));
+    }
+    appendCString(builder, "}");
+    return;
+  }
+
   if (object->type == OBJ_FUNCTION) {
     ObjFunction* function = AS_FUNCTION(value);
     if (function->name == NULL) {
@@ -290,6 +353,55 @@ static void appendValue(StringBuilder* builder, Value value) {
     return;
   }
 
+  if (object->type == OBJ_FLOAT_ARRAY) {
+    ObjFloatArray* array = AS_FLOAT_ARRAY(value);
+    appendCString(builder, "FloatArray[");
+    for (int i = 0; i < array->count; i++) {
+      if (i > 0) appendCString(builder, ", ");
+      appendValue(builder, NUMBER_VAL(array->values[i]));
+    }
+    appendCString(builder, "]");
+    return;
+  }
+
+  if (object->type == OBJ_PRIORITY_QUEUE) {
+    appendCString(builder, "<priority queue>");
+    return;
+  }
+
+  if (object->type == OBJ_RANGE) {
+    ObjRange* range = AS_RANGE(value);
+    appendCString(builder, "range(");
+    appendValue(builder, NUMBER_VAL(range->start));
+    appendCString(builder, ", ");
+    appendValue(builder, NUMBER_VAL(range->end));
+    appendCString(builder, ", ");
+    appendValue(builder, NUMBER_VAL(range->step));
+    appendCString(builder, ")");
+    return;
+  }
+
+  if (object->type == OBJ_SEQUENCE) {
+    appendCString(builder, "<sequence>");
+    return;
+  }
+
+  if (object->type == OBJ_BYTES) {
+    ObjString* string = AS_BYTES(value)->string;
+    appendCString(builder, "Bytes[");
+    for (int i = 0; i < string->length; i++) {
+      if (i > 0) appendCString(builder, ", ");
+      appendValue(builder, NUMBER_VAL((uint8_t)string->chars[i]));
+    }
+    appendCString(builder, "]");
+    return;
+  }
+
+  if (object->type == OBJ_STRING_BUILDER) {
+    appendCString(builder, "<string builder>");
+    return;
+  }
+
   if (object->type == OBJ_NATIVE) {
     appendCString(builder, "<native fn>");
     return;
@@ -326,8 +438,23 @@ static void appendValue(StringBuilder* builder, Value value) {
 ObjString* valueToString(Value value) {
   StringBuilder builder = {0};
   appendValue(&builder, value);
+  if (builder.chars == NULL) return vm.emptyString;
   ObjString* string = copyString(builder.chars, builder.count);
-  free(builder.chars);
-  free(builder.active);
+  freeStringBuilder(&builder);
   return string;
 }
+
+void freeStringBuilder(StringBuilder* builder) {
+  if (builder->counted) {
+    FREE_ARRAY(char, builder->chars, builder->capacity);
+  } else {
+    rawReallocate(builder->chars, (size_t)builder->capacity, 0);
+  }
+  rawReallocate(builder->active, sizeof(Obj*) * (size_t)builder->activeCapacity, 0);
+  builder->chars = NULL;
+  builder->count = 0;
+  builder->capacity = 0;
+  builder->active = NULL;
+  builder->activeCount = 0;
+  builder->activeCapacity = 0;
+}
@@ -13,6 +13,7 @@
 #include "headers/vm.h"
 #include "headers/native.h"
 #include "headers/pb.h"
+#include "headers/range.h"
 
 VM *activeVM = NULL;
 static VM defaultVM;
@@ -42,12 +43,12 @@ void runtimeError(const char *format, ...)
 
   if (length >= 0)
   {
-    char *message = (char *)malloc((size_t)length + 1);
+    char *message = (char *)rawReallocate(NULL, 0, (size_t)length + 1);
     if (message != NULL)
     {
       vsnprintf(message, (size_t)length + 1, format, args);
       reportDiagnostic(PB_DIAGNOSTIC_RUNTIME, message);
-      free(message);
+      rawReallocate(message, (size_t)length + 1, 0);
     }
   }
   va_end(args);
@@ -106,7 +107,8 @@ void reportDiagnostic(PbDiagnosticKind kind, const char *message)
   fprintf(stderr, "%s\n", message);
 }
 
-static void initialiseActiveVM(const PbConfig *config)
+// false when the allocator or heap cap leaves too little room to start
+static bool initialiseActiveVM(const PbConfig *config)
 {
   memset(activeVM, 0, sizeof(*activeVM));
   if (config != NULL)
@@ -114,14 +116,24 @@ static void initialiseActiveVM(const PbConfig *config)
 
   resetStack();
   vm.hadRuntimeError = false;
-  vm.nextGC = 1024 * 1024;
+  vm.nextGC = initialGCThreshold();
 
   initTable(&vm.globals);
   initTable(&vm.prelude);
   initTable(&vm.strings);
   initTable(&vm.modules);
+  if (!reserveSparePage())
+    return false;
 
+  vm.emptyString = copyString("", 0);
   vm.initString = copyString("init", 4);
+  for (int byte = 0; byte < 256; byte++)
+  {
+    char chars[1] = {(char)byte};
+    vm.byteStrings[byte] = copyString(chars, 1);
+  }
+  if (vm.hadRuntimeError)
+    return false;
 
   vm.randomState = (uint32_t)time(NULL) ^ (uint32_t)(uintptr_t)activeVM;
   if (vm.randomState == 0)
@@ -133,7 +145,30 @@ static void initialiseActiveVM(const PbConfig *config)
   defineNative("len", lenNative);
   defineNative("type", typeNative);
   defineNative("str", strNative);
+  defineNative("Set", setNative);
+  defineNative("PriorityQueue", priorityQueueNative);
+  defineNative("FloatArray", floatArrayNative);
+  defineNative("range", rangeNative);
+  defineNative("StringBuilder", stringBuilderNative);
+  defineNative("chr", chrNative);
+  defineNative("ord", ordNative);
   tableAddAll(&vm.globals, &vm.prelude);
+  return !vm.hadRuntimeError;
+}
+
+static char *copyHostString(const char *source)
+{
+  size_t length = strlen(source);
+  char *copy = (char *)rawReallocate(NULL, 0, length + 1);
+  if (copy != NULL)
+    memcpy(copy, source, length + 1);
+  return copy;
+}
+
+static void freeHostString(const char *string)
+{
+  if (string != NULL)
+    rawReallocate((char *)string, strlen(string) + 1, 0);
 }
 
 static void freeCapabilities(void)
@@ -141,13 +176,15 @@ static void freeCapabilities(void)
   for (size_t i = 0; i < vm.capabilityCount; i++)
   {
     HostCapability *capability = &vm.capabilities[i];
-    free(capability->name);
-    free(capability->source);
+    freeHostString(capability->name);
+    freeHostString(capability->source);
     for (size_t j = 0; j < capability->definitionCount; j++)
-      free((char *)capability->definitions[j].name);
-    free(capability->definitions);
+      freeHostString(capability->definitions[j].name);
+    rawReallocate(capability->definitions,
+                  sizeof(PbNativeDefinition) * capability->definitionCount, 0);
   }
-  free(vm.capabilities);
+  rawReallocate(vm.capabilities,
+                sizeof(HostCapability) * vm.capabilityCapacity, 0);
   vm.capabilities = NULL;
   vm.capabilityCount = 0;
   vm.capabilityCapacity = 0;
@@ -160,6 +197,8 @@ static void freeActiveVM(void)
   freeTable(&vm.strings);
   freeTable(&vm.modules);
   vm.initString = NULL;
+  vm.emptyString = NULL;
+  memset(vm.byteStrings, 0, sizeof(vm.byteStrings));
   freeObjects();
   freeCapabilities();
 }
@@ -265,16 +304,6 @@ static PbValue valueToHost(Value value)
   return result;
 }
 
-static bool activeVMOwnsObject(const void *pointer)
-{
-  for (Obj *object = vm.objects; object != NULL; object = object->next)
-  {
-    if (object == pointer)
-      return true;
-  }
-  return false;
-}
-
 static bool hostToValue(PbValue value, Value *result)
 {
   switch (value.type)
@@ -301,7 +330,7 @@ static bool hostToValue(PbValue value, Value *result)
                                  (int)value.as.string.length));
     return true;
   case PB_VALUE_OBJECT:
-    if (!activeVMOwnsObject(value.as.object))
+    if (!heapContainsObject(value.as.object))
     {
       runtimeError("Host supplied an object that does not belong to this VM.");
       return false;
@@ -325,7 +354,8 @@ static bool callNativeObject(ObjNative *native, int argCount, Value *args,
   PbValue *hostArgs = NULL;
   if (argCount > 0)
   {
-    hostArgs = (PbValue *)malloc(sizeof(PbValue) * (size_t)argCount);
+    hostArgs = (PbValue *)rawReallocate(NULL, 0,
+                                        sizeof(PbValue) * (size_t)argCount);
     if (hostArgs == NULL)
     {
       runtimeError("Could not allocate host-call arguments.");
@@ -337,7 +367,7 @@ static bool callNativeObject(ObjNative *native, int argCount, Value *args,
 
   PbValue hostResult = native->hostFunction(
       activeVM, argCount, hostArgs, native->userData);
-  free(hostArgs);
+  rawReallocate(hostArgs, sizeof(PbValue) * (size_t)argCount, 0);
 
   if (vm.hadRuntimeError)
     return false;
@@ -456,6 +486,38 @@ static bool invokeListMethod(ObjString *name, int argCount)
   {
     method = listSortNative;
   }
+  else if (strcmp(name->chars, "reserve") == 0)
+  {
+    method = listReserveNative;
+  }
+  else if (strcmp(name->chars, "shrinkToFit") == 0)
+  {
+    method = listShrinkToFitNative;
+  }
+  else if (strcmp(name->chars, "map") == 0)
+  {
+    method = listMapNative;
+  }
+  else if (strcmp(name->chars, "filter") == 0)
+  {
+    method = listFilterNative;
+  }
+  else if (strcmp(name->chars, "reduce") == 0)
+  {
+    method = listReduceNative;
+  }
+  else if (strcmp(name->chars, "forEach") == 0)
+  {
+    method = listForEachNative;
+  }
+  else if (strcmp(name->chars, "any") == 0)
+  {
+    method = listAnyNative;
+  }
+  else if (strcmp(name->chars, "all") == 0)
+  {
+    method = listAllNative;
+  }
   else
   {
     runtimeError("Lists do not have a method named '%s'.", name->chars);
@@ -492,6 +554,14 @@ static bool invokeMapMethod(ObjString *name, int argCount)
   {
     method = mapClearNative;
   }
+  else if (strcmp(name->chars, "reserve") == 0)
+  {
+    method = mapReserveNative;
+  }
+  else if (strcmp(name->chars, "shrinkToFit") == 0)
+  {
+    method = mapShrinkToFitNative;
+  }
   else
   {
     runtimeError("Maps do not have a method named '%s'.", name->chars);
@@ -506,6 +576,264 @@ static bool invokeMapMethod(ObjString *name, int argCount)
   return true;
 }
 
+static bool invokeSetMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "add") == 0)
+  {
+    method = setAddNative;
+  }
+  else if (strcmp(name->chars, "has") == 0)
+  {
+    method = setHasNative;
+  }
+  else if (strcmp(name->chars, "delete") == 0)
+  {
+    method = setDeleteNative;
+  }
+  else if (strcmp(name->chars, "clear") == 0)
+  {
+    method = setClearNative;
+  }
+  else if (strcmp(name->chars, "union") == 0)
+  {
+    method = setUnionNative;
+  }
+  else if (strcmp(name->chars, "intersection") == 0)
+  {
+    method = setIntersectionNative;
+  }
+  else if (strcmp(name->chars, "difference") == 0)
+  {
+    method = setDifferenceNative;
+  }
+  else if (strcmp(name->chars, "values") == 0)
+  {
+    method = setValuesNative;
+  }
+  else
+  {
+    runtimeError("Sets do not have a method named '%s'.", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
+static bool invokePriorityQueueMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "push") == 0)
+  {
+    method = priorityQueuePushNative;
+  }
+  else if (strcmp(name->chars, "pop") == 0)
+  {
+    method = priorityQueuePopNative;
+  }
+  else if (strcmp(name->chars, "peek") == 0)
+  {
+    method = priorityQueuePeekNative;
+  }
+  else
+  {
+    runtimeError("Priority queues do not have a method named '%s'.", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
+static bool invokeFloatArrayMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "fill") == 0)
+  {
+    method = floatArrayFillNative;
+  }
+  else if (strcmp(name->chars, "scale") == 0)
+  {
+    method = floatArrayScaleNative;
+  }
+  else if (strcmp(name->chars, "add") == 0)
+  {
+    method = floatArrayAddNative;
+  }
+  else if (strcmp(name->chars, "sum") == 0)
+  {
+    method = floatArraySumNative;
+  }
+  else if (strcmp(name->chars, "min") == 0)
+  {
+    method = floatArrayMinNative;
+  }
+  else if (strcmp(name->chars, "max") == 0)
+  {
+    method = floatArrayMaxNative;
+  }
+  else if (strcmp(name->chars, "toList") == 0)
+  {
+    method = floatArrayToListNative;
+  }
+  else
+  {
+    runtimeError("Float arrays do not have a method named '%s'.", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
+// ranges and the lazy sequences built on them share their methods
+static bool invokeSequenceMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "map") == 0)
+  {
+    method = sequenceMapNative;
+  }
+  else if (strcmp(name->chars, "filter") == 0)
+  {
+    method = sequenceFilterNative;
+  }
+  else if (strcmp(name->chars, "reduce") == 0)
+  {
+    method = sequenceReduceNative;
+  }
+  else if (strcmp(name->chars, "toList") == 0)
+  {
+    method = sequenceToListNative;
+  }
+  else
+  {
+    runtimeError("%s do not have a method named '%s'.",
+                 IS_RANGE(peek(argCount)) ? "Ranges" : "Sequences", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
+static bool invokeStringMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "find") == 0)
+  {
+    method = stringFindNative;
+  }
+  else if (strcmp(name->chars, "split") == 0)
+  {
+    method = stringSplitNative;
+  }
+  else if (strcmp(name->chars, "join") == 0)
+  {
+    method = stringJoinNative;
+  }
+  else if (strcmp(name->chars, "replace") == 0)
+  {
+    method = stringReplaceNative;
+  }
+  else if (strcmp(name->chars, "startsWith") == 0)
+  {
+    method = stringStartsWithNative;
+  }
+  else if (strcmp(name->chars, "endsWith") == 0)
+  {
+    method = stringEndsWithNative;
+  }
+  else if (strcmp(name->chars, "trim") == 0)
+  {
+    method = stringTrimNative;
+  }
+  else if (strcmp(name->chars, "upper") == 0)
+  {
+    method = stringUpperNative;
+  }
+  else if (strcmp(name->chars, "lower") == 0)
+  {
+    method = stringLowerNative;
+  }
+  else if (strcmp(name->chars, "bytes") == 0)
+  {
+    method = stringBytesNative;
+  }
+  else
+  {
+    runtimeError("Strings do not have a method named '%s'.", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
+static bool invokeStringBuilderMethod(ObjString *name, int argCount)
+{
+  NativeFn method = NULL;
+
+  if (strcmp(name->chars, "append") == 0)
+  {
+    method = stringBuilderAppendNative;
+  }
+  else if (strcmp(name->chars, "appendLine") == 0)
+  {
+    method = stringBuilderAppendLineNative;
+  }
+  else if (strcmp(name->chars, "len") == 0)
+  {
+    method = stringBuilderLenNative;
+  }
+  else if (strcmp(name->chars, "clear") == 0)
+  {
+    method = stringBuilderClearNative;
+  }
+  else if (strcmp(name->chars, "build") == 0)
+  {
+    method = stringBuilderBuildNative;
+  }
+  else
+  {
+    runtimeError("String builders do not have a method named '%s'.", name->chars);
+    return false;
+  }
+
+  Value result = method(argCount + 1, vm.stackTop - argCount - 1);
+  if (vm.hadRuntimeError) return false;
+
+  vm.stackTop -= argCount + 1;
+  push(result);
+  return true;
+}
+
 static bool invoke(ObjString *name, int argCount)
 {
   Value receiver = peek(argCount);
@@ -534,6 +862,36 @@ static bool invoke(ObjString *name, int argCount)
     return invokeMapMethod(name, argCount);
   }
 
+  if (IS_SET(receiver))
+  {
+    return invokeSetMethod(name, argCount);
+  }
+
+  if (IS_PRIORITY_QUEUE(receiver))
+  {
+    return invokePriorityQueueMethod(name, argCount);
+  }
+
+  if (IS_FLOAT_ARRAY(receiver))
+  {
+    return invokeFloatArrayMethod(name, argCount);
+  }
+
+  if (IS_RANGE(receiver) || IS_SEQUENCE(receiver))
+  {
+    return invokeSequenceMethod(name, argCount);
+  }
+
+  if (IS_STRING(receiver))
+  {
+    return invokeStringMethod(name, argCount);
+  }
+
+  if (IS_STRING_BUILDER(receiver))
+  {
+    return invokeStringBuilderMethod(name, argCount);
+  }
+
   if (!IS_INSTANCE(receiver))
   {
     runtimeError("Only instances have methods.");
@@ -567,12 +925,6 @@ static bool bindMethod(ObjClass *klass, ObjString *name)
   return true;
 }
 
-// only nil and false are falsey
-static bool isFalsey(Value value)
-{
-  return IS_NIL(value) || (IS_BOOL(value) && !AS_BOOL(value));
-}
-
 static ObjUpvalue *captureUpvalue(Value *local)
 {
   ObjUpvalue *previous = NULL;
@@ -620,6 +972,8 @@ static void concatenate()
 
   int length = strA->length + strB->length;
   char *chars = ALLOCATE(char, length + 1);
+  if (chars == NULL)
+    return;
   memcpy(chars, strA->chars, strA->length);
   memcpy(chars + strA->length, strB->chars, strB->length);
   chars[length] = '\0';
@@ -676,6 +1030,147 @@ static Table *globalsForFrame(CallFrame *frame)
   return &vm.globals;
 }
 
+typedef enum
+{
+  ITER_ELEMENT,
+  ITER_DONE,
+  ITER_ERROR,
+} IterStep;
+
+// Advances a for-in loop whose state sits at the top of the stack: the
+// collection, a cursor with the next position to look at, and a guard with
+// the modification count a map or set had when the loop began. Pushes the
+// next element, or its key or index and then the element when the loop names
+// two variables. Lists are read by raw position and their length re-read
+// every step, so a body that pushes or pops never reads past the end.
+static IterStep iterNext(int names)
+{
+  Value *state = vm.stackTop - 3;
+  Value collection = state[0];
+
+  // a range or sequence counts its cursor in range elements, which may be
+  // more than an int holds
+  if (IS_RANGE(collection) || IS_SEQUENCE(collection))
+  {
+    if (names == 2)
+    {
+      runtimeError("Ranges and sequences iterate with one variable.");
+      return ITER_ERROR;
+    }
+    double consumed = AS_NUMBER(state[1]);
+    Value element;
+    if (!sequenceNext(collection, &consumed, &element))
+      return vm.hadRuntimeError ? ITER_ERROR : ITER_DONE;
+    push(element);
+    // a filter stage may have consumed more than one element
+    state[1] = NUMBER_VAL(consumed);
+    return ITER_ELEMENT;
+  }
+
+  int position = (int)AS_NUMBER(state[1]);
+  if (IS_LIST(collection))
+  {
+    ObjList *list = AS_LIST(collection);
+    if (position >= list->items.count)
+      return ITER_DONE;
+    if (names == 2)
+      push(NUMBER_VAL(position));
+    push(list->items.values[position]);
+  }
+  else if (IS_HASHMAP(collection))
+  {
+    // a rebuild renumbers the entries under the cursor, so any insert or
+    // delete, each of which may cause one, ends the loop
+    Map *map = &AS_HASHMAP(collection)->items;
+    if (map->modifications != (uint32_t)AS_NUMBER(state[2]))
+    {
+      runtimeError("Map was modified during iteration.");
+      return ITER_ERROR;
+    }
+    position = mapNextEntry(map, position - 1);
+    if (position == -1)
+      return ITER_DONE;
+    MapEntry *entry = mapEntryAt(map, position);
+    push(entry->key);
+    if (names == 2)
+      push(entry->value);
+  }
+  else if (IS_SET(collection))
+  {
+    Set *set = &AS_SET(collection)->items;
+    if (names == 2)
+    {
+      runtimeError("Sets iterate with one variable.");
+      return ITER_ERROR;
+    }
+    if (set->modifications != (uint32_t)AS_NUMBER(state[2]))
+    {
+      runtimeError("Set was modified during iteration.");
+      return ITER_ERROR;
+    }
+    position = setNextKey(set, position - 1);
+    if (position == -1)
+      return ITER_DONE;
+    push(SET_KEY_AT(set, position));
+  }
+  else if (IS_FLOAT_ARRAY(collection))
+  {
+    ObjFloatArray *array = AS_FLOAT_ARRAY(collection);
+    if (position >= array->count)
+      return ITER_DONE;
+    if (names == 2)
+      push(NUMBER_VAL(position));
+    push(NUMBER_VAL(array->values[position]));
+  }
+  else if (IS_BYTES(collection))
+  {
+    ObjString *string = AS_BYTES(collection)->string;
+    if (position >= string->length)
+      return ITER_DONE;
+    if (names == 2)
+      push(NUMBER_VAL(position));
+    push(NUMBER_VAL((uint8_t)string->chars[position]));
+  }
+  else
+  {
+    ObjString *string = AS_STRING(collection);
+    if (position >= string->length)
+      return ITER_DONE;
+    if (names == 2)
+      push(NUMBER_VAL(position));
+    push(OBJ_VAL(vm.byteStrings[(uint8_t)string->chars[position]]));
+  }
+
+  state[1] = NUMBER_VAL(position + 1);
+  return ITER_ELEMENT;
+}
+
+// Starts a for-in loop over the collection on top of the stack, which stays
+// there under the cursor and the guard.
+static bool iterInit(void)
+{
+  Value collection = peek(0);
+  Value guard = NIL_VAL;
+  if (IS_HASHMAP(collection))
+  {
+    guard = NUMBER_VAL(AS_HASHMAP(collection)->items.modifications);
+  }
+  else if (IS_SET(collection))
+  {
+    guard = NUMBER_VAL(AS_SET(collection)->items.modifications);
+  }
+  else if (!IS_LIST(collection) && !IS_FLOAT_ARRAY(collection) &&
+           !IS_STRING(collection) && !IS_BYTES(collection) &&
+           !IS_RANGE(collection) && !IS_SEQUENCE(collection))
+  {
+    runtimeError("Can only iterate over lists, maps, sets, float arrays, strings, bytes, and sequences.");
+    return false;
+  }
+  push(NUMBER_VAL(0));
+  push(guard);
+  return true;
+}
+
 static InterpretResult run(int stopFrameCount)
 {
   CallFrame *frame = &vm.frames[vm.frameCount - 1];
@@ -831,6 +1326,71 @@ static InterpretResult run(int stopFrameCount)
         break;
       }
 
+      if (IS_SET(peek(0)))
+      {
+        if (strcmp(name->chars, "length") != 0)
+        {
+          runtimeError("Sets do not have a property named '%s'.", name->chars);
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        ObjSet *set = AS_SET(pop());
+        push(NUMBER_VAL(setCount(&set->items)));
+        break;
+      }
+
+      if (IS_PRIORITY_QUEUE(peek(0)))
+      {
+        if (strcmp(name->chars, "length") != 0)
+        {
+          runtimeError("Priority queues do not have a property named '%s'.", name->chars);
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        ObjPriorityQueue *queue = AS_PRIORITY_QUEUE(pop());
+        push(NUMBER_VAL(queue->items.count));
+        break;
+      }
+
+      if (IS_FLOAT_ARRAY(peek(0)))
+      {
+        if (strcmp(name->chars, "length") != 0)
+        {
+          runtimeError("Float arrays do not have a property named '%s'.", name->chars);
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        ObjFloatArray *array = AS_FLOAT_ARRAY(pop());
+        push(NUMBER_VAL(array->count));
+        break;
+      }
+
+      if (IS_BYTES(peek(0)))
+      {
+        if (strcmp(name->chars, "length") != 0)
+        {
+          runtimeError("Bytes do not have a property named '%s'.", name->chars);
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        ObjBytes *bytes = AS_BYTES(pop());
+        push(NUMBER_VAL(bytes->string->length));
+        break;
+      }
+
+      if (IS_RANGE(peek(0)))
+      {
+        if (strcmp(name->chars, "length") != 0)
+        {
+          runtimeError("Ranges do not have a property named '%s'.", name->chars);
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        ObjRange *range = AS_RANGE(pop());
+        push(NUMBER_VAL(rangeCount(range)));
+        break;
+      }
+
       if (!IS_INSTANCE(peek(0)))
       {
         runtimeError("Only instances have properties.");
@@ -1037,6 +1597,79 @@ static InterpretResult run(int stopFrameCount)
       frame->ip -= offset;
       break;
     }
+    case OP_ITER_INIT:
+    {
+      if (!iterInit())
+        return INTERPRET_RUNTIME_ERROR;
+      break;
+    }
+    case OP_RANGE_INIT:
+    {
+      int argCount = READ_BYTE();
+      Value callee = peek(argCount);
+      if (IS_NATIVE(callee) && AS_NATIVE(callee)->legacyFunction == rangeNative)
+      {
+        double start, end, step;
+        if (!rangeArguments(argCount, vm.stackTop - argCount, &start, &end, &step))
+          return INTERPRET_RUNTIME_ERROR;
+
+        // a counted loop keeps the next number, the step and the end where
+        // the collection, cursor and guard would be, and no range object
+        vm.stackTop -= argCount + 1;
+        push(NUMBER_VAL(start));
+        push(NUMBER_VAL(step));
+        push(NUMBER_VAL(end));
+        break;
+      }
+
+      // range has been rebound: make the call and loop over its result
+      int frameCount = vm.frameCount;
+      if (!callValue(callee, argCount))
+        return INTERPRET_RUNTIME_ERROR;
+      if (vm.frameCount > frameCount && run(frameCount) != INTERPRET_OK)
+        return INTERPRET_RUNTIME_ERROR;
+      if (!iterInit())
+        return INTERPRET_RUNTIME_ERROR;
+      break;
+    }
+    case OP_ITER_NEXT:
+    {
+      int names = READ_BYTE();
+      uint16_t offset = READ_SHORT();
+      IterStep step = iterNext(names);
+      if (step == ITER_ERROR)
+        return INTERPRET_RUNTIME_ERROR;
+      if (step == ITER_DONE)
+        frame->ip += offset;
+      break;
+    }
+    case OP_RANGE_NEXT:
+    {
+      int names = READ_BYTE();
+      uint16_t offset = READ_SHORT();
+      Value *state = vm.stackTop - 3;
+      if (IS_NUMBER(state[0]))
+      {
+        double next = AS_NUMBER(state[0]);
+        double step = AS_NUMBER(state[1]);
+        if (step > 0 ? next >= AS_NUMBER(state[2]) : next <= AS_NUMBER(state[2]))
+        {
+          frame->ip += offset;
+          break;
+        }
+        state[0] = NUMBER_VAL(next + step);
+        push(NUMBER_VAL(next));
+        break;
+      }
+
+      // whatever a rebound range returned takes the general path
+      IterStep step = iterNext(names);
+      if (step == ITER_ERROR)
+        return INTERPRET_RUNTIME_ERROR;
+      if (step == ITER_DONE)
+        frame->ip += offset;
+      break;
+    }
     case OP_CALL:
     {
       int argCount = READ_BYTE();
@@ -1067,6 +1700,34 @@ static InterpretResult run(int stopFrameCount)
         pop();
         push(result);
       }
+      else if (IS_FLOAT_ARRAY(container))
+      {
+        ObjFloatArray *array = AS_FLOAT_ARRAY(container);
+        int arrayIndex;
+
+        if (!normalizeListIndex(index, array->count, &arrayIndex))
+        {
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        pop();
+        pop();
+        push(NUMBER_VAL(array->values[arrayIndex]));
+      }
+      else if (IS_BYTES(container))
+      {
+        ObjString *string = AS_BYTES(container)->string;
+        int byteIndex;
+
+        if (!normalizeListIndex(index, string->length, &byteIndex))
+        {
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        pop();
+        pop();
+        push(NUMBER_VAL((uint8_t)string->chars[byteIndex]));
+      }
       else if (IS_STRING(container))
       {
         if (!IS_NUMBER(index))
@@ -1088,9 +1749,7 @@ static InterpretResult run(int stopFrameCount)
           runtimeError("String index out of bounds.");
           return INTERPRET_RUNTIME_ERROR;
         }
-        char chars[2] = {string->chars[(int)stringIndex], '\0'};
-
-        ObjString *result = copyString(chars, 1);
+        ObjString *result = vm.byteStrings[(uint8_t)string->chars[(int)stringIndex]];
 
         pop();
         pop();
@@ -1113,7 +1772,7 @@ static InterpretResult run(int stopFrameCount)
       }
       else
       {
-        runtimeError("Can only index into lists, strings, and hashmaps.");
+        runtimeError("Can only index into lists, float arrays, strings, bytes, and hashmaps.");
         return INTERPRET_RUNTIME_ERROR;
       }
 
@@ -1143,6 +1802,28 @@ static InterpretResult run(int stopFrameCount)
         pop();
         push(value);
       }
+      else if (IS_FLOAT_ARRAY(container))
+      {
+        ObjFloatArray *array = AS_FLOAT_ARRAY(container);
+        int index;
+
+        if (!normalizeListIndex(key, array->count, &index))
+        {
+          return INTERPRET_RUNTIME_ERROR;
+        }
+        if (!IS_NUMBER(value))
+        {
+          runtimeError("Float array elements must be numbers.");
+          return INTERPRET_RUNTIME_ERROR;
+        }
+
+        array->values[index] = AS_NUMBER(value);
+
+        pop();
+        pop();
+        pop();
+        push(value);
+      }
       else if (IS_HASHMAP(container))
       {
         if (!mapKeyIsValid(key))
@@ -1164,7 +1845,7 @@ static InterpretResult run(int stopFrameCount)
       }
       else
       {
-        runtimeError("Can only assign through a list or hashmap index.");
+        runtimeError("Can only assign through a list, float array, or hashmap index.");
         return INTERPRET_RUNTIME_ERROR;
       }
 
@@ -1173,62 +1854,66 @@ static InterpretResult run(int stopFrameCount)
 
     case OP_NEW_LIST:
     {
-      push(OBJ_VAL(newList()));
+      uint16_t count = READ_SHORT();
+      ObjList *list = newList();
+      push(OBJ_VAL(list));
+      listReserve(list, count);
       break;
     }
-    case OP_LIST_LITERAL_APPEND:
+    case OP_LIST_TEMPLATE:
     {
-      Value item = pop();
-      Value listVal = pop();
-
-      if (!IS_LIST(listVal))
-      {
-        runtimeError("Can only append to a list.");
-        return INTERPRET_RUNTIME_ERROR;
-      }
-
-      ObjList *list = AS_LIST(listVal);
-      push(OBJ_VAL(list));
-      writeValueArray(&list->items, item);
-      pop();
+      ObjList *template = AS_LIST(frame->closure->function->chunk.constants.values[READ_SHORT()]);
+      ObjList *list = newList();
       push(OBJ_VAL(list));
+      if (!listReserve(list, template->items.capacity))
+        break;
+      memcpy(list->items.values, template->items.values,
+             sizeof(Value) * (size_t)template->items.count);
+      list->items.count = template->items.count;
+      break;
+    }
+    case OP_BUILD_LIST:
+    {
+      int count = READ_BYTE();
+      ObjList *list = AS_LIST(peek(count));
+      if (!listReserve(list, list->items.count + count))
+        break;
+      memcpy(list->items.values + list->items.count, vm.stackTop - count,
+             sizeof(Value) * (size_t)count);
+      list->items.count += count;
+      vm.stackTop -= count;
       break;
     }
     case OP_NEW_HASHMAP:
     {
-      push(OBJ_VAL(newHashmap()));
+      uint16_t count = READ_SHORT();
+      ObjHashmap *hashmap = newHashmap();
+      push(OBJ_VAL(hashmap));
+      mapReserve(&hashmap->items, count);
       break;
     }
-    case OP_HASHMAP_LITERAL_INSERT:
+    case OP_MAP_TEMPLATE:
     {
-      Value value = peek(0);
-      Value keyVal = peek(1);
-      Value hashmapVal = peek(2);
-
-      if (!IS_HASHMAP(hashmapVal))
-      {
-        runtimeError("Expect a hashmap.");
-        return INTERPRET_RUNTIME_ERROR;
-      }
-
-      ObjHashmap *hashmap = AS_HASHMAP(hashmapVal);
-
-      if (!mapKeyIsValid(keyVal))
-      {
-        runtimeError("Map keys must be nil, booleans, finite numbers, or strings.");
-        return INTERPRET_RUNTIME_ERROR;
-      }
-
-      if (!mapSet(&hashmap->items, keyVal, value, NULL))
+      ObjHashmap *template = AS_HASHMAP(frame->closure->function->chunk.constants.values[READ_SHORT()]);
+      ObjHashmap *hashmap = newHashmap();
+      push(OBJ_VAL(hashmap));
+      mapCopy(&template->items, &hashmap->items);
+      break;
+    }
+    case OP_BUILD_MAP:
+    {
+      int count = READ_BYTE();
+      ObjHashmap *hashmap = AS_HASHMAP(peek(count * 2));
+      for (Value *pair = vm.stackTop - count * 2; pair < vm.stackTop; pair += 2)
       {
-        runtimeError("Map key is invalid.");
-        return INTERPRET_RUNTIME_ERROR;
+        if (!mapKeyIsValid(pair[0]))
+        {
+          runtimeError("Map keys must be nil, booleans, finite numbers, or strings.");
+          return INTERPRET_RUNTIME_ERROR;
+        }
+        mapSet(&hashmap->items, pair[0], pair[1], NULL);
       }
-
-      pop();
-      pop();
-      pop();
-      push(OBJ_VAL(hashmap));
+      vm.stackTop -= count * 2;
       break;
     }
     case OP_CLOSURE:
@@ -1327,7 +2012,13 @@ static InterpretResult run(int stopFrameCount)
       break;
     }
     }
-    if (vm.hadRuntimeError) return INTERPRET_RUNTIME_ERROR;
+    if (vm.hadRuntimeError)
+    {
+      // an error raised mid-instruction (such as running out of heap) may
+      // have been followed by pushes onto the already reset stack
+      resetStack();
+      return INTERPRET_RUNTIME_ERROR;
+    }
   }
 #undef BINARY_OP
 #undef READ_CONSTANT
@@ -1336,6 +2027,80 @@ static InterpretResult run(int stopFrameCount)
 #undef READ_BYTE
 }
 
+// lets a native call back into script code: a closure runs to completion on
+// top of the frames already active, then its result is handed back. On false
+// a runtime error has been reported and the stack reset, so the native must
+// return straight away.
+bool callFromNative(Value callee, int argCount, Value *args, Value *result)
+{
+  int frameCount = vm.frameCount;
+  if (!push(callee))
+    return false;
+  for (int i = 0; i < argCount; i++)
+  {
+    if (!push(args[i]))
+      return false;
+  }
+
+  if (!callValue(callee, argCount))
+    return false;
+  if (vm.frameCount > frameCount && run(frameCount) != INTERPRET_OK)
+    return false;
+
+  *result = pop();
+  return true;
+}
+
+bool prepareCallback(NativeCallback *callback, Value callee, int argCount)
+{
+  callback->callee = callee;
+  callback->closure = NULL;
+  callback->argCount = argCount;
+  if (!IS_CLOSURE(callee))
+    return true;
+
+  ObjFunction *function = AS_CLOSURE(callee)->function;
+  if (function->arity != argCount)
+  {
+    runtimeError("Expected %d arguments but got %d.", function->arity, argCount);
+    return false;
+  }
+  callback->closure = AS_CLOSURE(callee);
+  return true;
+}
+
+// the same as callFromNative, minus the arity check and the dispatch on the
+// callee's type that prepareCallback has already done
+bool invokeCallback(NativeCallback *callback, Value *args, Value *result)
+{
+  if (callback->closure == NULL)
+    return callFromNative(callback->callee, callback->argCount, args, result);
+
+  int argCount = callback->argCount;
+  if (vm.frameCount == FRAMES_MAX ||
+      vm.stackTop + argCount + 1 > vm.stack + STACK_MAX)
+  {
+    runtimeError("Stack overflow.");
+    return false;
+  }
+
+  Value *slots = vm.stackTop;
+  slots[0] = callback->callee;
+  memcpy(slots + 1, args, sizeof(Value) * (size_t)argCount);
+  vm.stackTop = slots + argCount + 1;
+
+  int frameCount = vm.frameCount;
+  CallFrame *frame = &vm.frames[vm.frameCount++];
+  frame->closure = callback->closure;
+  frame->ip = callback->closure->function->chunk.code;
+  frame->slots = slots;
+  if (run(frameCount) != INTERPRET_OK)
+    return false;
+
+  *result = *--vm.stackTop;
+  return true;
+}
+
 static InterpretResult interpretActive(const char *source)
 {
   vm.hadRuntimeError = false;
@@ -1344,6 +2109,8 @@ static InterpretResult interpretActive(const char *source)
   ObjFunction *function = compile(source);
   if (function == NULL)
     return INTERPRET_COMPILE_ERROR;
+  if (vm.hadRuntimeError)
+    return INTERPRET_RUNTIME_ERROR;
 
   if (!push(OBJ_VAL(function))) return INTERPRET_RUNTIME_ERROR;
   ObjClosure *closure = newClosure(function);
@@ -1372,15 +2139,6 @@ static VM *activateVM(PbVM *instance)
   return previous;
 }
 
-static char *copyHostString(const char *source)
-{
-  size_t length = strlen(source);
-  char *copy = (char *)malloc(length + 1);
-  if (copy != NULL)
-    memcpy(copy, source, length + 1);
-  return copy;
-}
-
 static bool validNativeName(const char *name)
 {
   return name != NULL && name[0] != '\0' && strlen(name) <= INT_MAX;
@@ -1523,12 +2281,22 @@ InterpretResult resolveModule(const char *name, Value *result)
 
 PB_API PbVM *pbCreateVM(const PbConfig *config)
 {
-  VM *instance = (VM *)malloc(sizeof(VM));
+  VM *instance;
+  if (config != NULL && config->allocator.reallocate != NULL)
+    instance = (VM *)config->allocator.reallocate(
+        NULL, 0, sizeof(VM), config->allocator.userData);
+  else
+    instance = (VM *)malloc(sizeof(VM));
   if (instance == NULL)
     return NULL;
   VM *previous = activateVM(instance);
-  initialiseActiveVM(config);
+  bool initialised = initialiseActiveVM(config);
   activeVM = previous;
+  if (!initialised)
+  {
+    pbDestroyVM(instance);
+    return NULL;
+  }
   return instance;
 }
 
@@ -1544,10 +2312,21 @@ PB_API void pbDestroyVM(PbVM *instance)
     activeVM = previous;
     return;
   }
-  freeActiveVM();
-  memset(instance, 0, sizeof(VM));
-  free(instance);
+  PbAllocator allocator = vm.config.allocator;
+  // an arena owns every allocation, including the VM itself
+  if (allocator.reallocate == NULL || allocator.release == NULL)
+  {
+    freeActiveVM();
+    memset(instance, 0, sizeof(VM));
+  }
   activeVM = previous == (VM *)instance ? NULL : previous;
+
+  if (allocator.release != NULL && allocator.reallocate != NULL)
+    allocator.release(allocator.userData);
+  else if (allocator.reallocate != NULL)
+    allocator.reallocate(instance, sizeof(VM), 0, allocator.userData);
+  else
+    free(instance);
 }
 
 PB_API PbResult pbInterpret(PbVM *instance, const char *source)
@@ -1610,8 +2389,9 @@ PB_API bool pbRegisterCapability(
   if (vm.capabilityCount == vm.capabilityCapacity)
   {
     size_t capacity = vm.capabilityCapacity < 4 ? 4 : vm.capabilityCapacity * 2;
-    HostCapability *capabilities = (HostCapability *)realloc(
-        vm.capabilities, sizeof(HostCapability) * capacity);
+    HostCapability *capabilities = (HostCapability *)rawReallocate(
+        vm.capabilities, sizeof(HostCapability) * vm.capabilityCapacity,
+        sizeof(HostCapability) * capacity);
     if (capabilities == NULL)
     {
       reportDiagnostic(PB_DIAGNOSTIC_HOST,
@@ -1633,11 +2413,11 @@ PB_API bool pbRegisterCapability(
 
   if (definitionCount > 0)
   {
-    capability.definitions = (PbNativeDefinition *)calloc(
-        definitionCount, sizeof(PbNativeDefinition));
+    capability.definitions = (PbNativeDefinition *)rawReallocate(
+        NULL, 0, sizeof(PbNativeDefinition) * definitionCount);
     if (capability.definitions == NULL)
     {
-      free(capability.name);
+      freeHostString(capability.name);
       activeVM = previous;
       return false;
     }
@@ -1651,9 +2431,10 @@ PB_API bool pbRegisterCapability(
     if (capability.definitions[i].name == NULL)
     {
       for (size_t j = 0; j < i; j++)
-        free((char *)capability.definitions[j].name);
-      free(capability.definitions);
-      free(capability.name);
+        freeHostString(capability.definitions[j].name);
+      rawReallocate(capability.definitions,
+                    sizeof(PbNativeDefinition) * definitionCount, 0);
+      freeHostString(capability.name);
       activeVM = previous;
       return false;
     }
@@ -1683,8 +2464,9 @@ PB_API bool pbRegisterModuleSource(PbVM *instance,
   if (vm.capabilityCount == vm.capabilityCapacity)
   {
     size_t capacity = vm.capabilityCapacity < 4 ? 4 : vm.capabilityCapacity * 2;
-    HostCapability *capabilities = (HostCapability *)realloc(
-        vm.capabilities, sizeof(HostCapability) * capacity);
+    HostCapability *capabilities = (HostCapability *)rawReallocate(
+        vm.capabilities, sizeof(HostCapability) * vm.capabilityCapacity,
+        sizeof(HostCapability) * capacity);
     if (capabilities == NULL)
     {
       reportDiagnostic(PB_DIAGNOSTIC_HOST,
@@ -1701,8 +2483,8 @@ PB_API bool pbRegisterModuleSource(PbVM *instance,
   capability.source = copyHostString(source);
   if (capability.name == NULL || capability.source == NULL)
   {
-    free(capability.name);
-    free(capability.source);
+    freeHostString(capability.name);
+    freeHostString(capability.source);
     activeVM = previous;
     return false;
   }
@@ -1751,7 +2533,7 @@ PB_API PbResult pbCall(PbVM *instance, const char *name,
   }
 
   vm.hasLastReturnValue = false;
-  if (!callValue(callee, argCount))
+  if (vm.hadRuntimeError || !callValue(callee, argCount))
   {
     activeVM = previous;
     return INTERPRET_RUNTIME_ERROR;
@@ -1773,6 +2555,34 @@ PB_API void pbRuntimeError(PbVM *instance, const char *message)
   activeVM = previous;
 }
 
+PB_API void pbCollectGarbage(PbVM *instance)
+{
+  if (instance == NULL)
+    return;
+  VM *previous = activateVM(instance);
+  collectGarbage();
+  activeVM = previous;
+}
+
+PB_API bool pbGetGCStats(PbVM *instance, PbGCStats *stats)
+{
+  if (instance == NULL || stats == NULL)
+    return false;
+  *stats = instance->gcStats;
+  stats->bytesAllocated = instance->bytesAllocated;
+  stats->nextCollection = instance->nextGC;
+  stats->heapGrowthFactor = instance->gcGrowthFactor;
+
+  TableStats strings;
+  tableGetStats(&instance->strings, &strings);
+  stats->internedStrings = (size_t)strings.count;
+  stats->internCapacity = (size_t)strings.capacity;
+  stats->internTombstones = (size_t)strings.tombstones;
+  stats->internMaxProbe = (size_t)strings.maxProbe;
+  stats->internAverageProbe = strings.averageProbe;
+  return true;
+}
+
 PB_API PbValue pbNilValue(void)
 {
   PbValue value = {0};
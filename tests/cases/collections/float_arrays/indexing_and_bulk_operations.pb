@@ -0,0 +1,55 @@
+var grid = FloatArray(5);
+print(grid);
+print(grid.length);
+print(len(grid));
+print(type(grid));
+grid[0] = 1.5;
+grid[-1] = 4;
+print(grid[0] + grid[4]);
+grid.fill(2);
+grid.scale(3);
+grid.add(0.5);
+print(grid);
+print(grid.sum());
+
+var samples = FloatArray([3, -2, 7.25, 0, 11, -9, 4]);
+print(samples.min());
+print(samples.max());
+print(samples.sum());
+samples.add(FloatArray([1, 1, 1, 1, 1, 1, 1]));
+print(samples.toList());
+print(FloatArray([1, 2]) == FloatArray([1, 2]));
+print(FloatArray([1, 2]) == FloatArray([1, 3]));
+print(str(FloatArray([])));
+
+fun bulk() {
+  var values = FloatArray(1001);
+  for (var i = 0; i < values.length; i = i + 1) values[i] = i;
+  print(values.sum());
+  print(values.min());
+  print(values.max());
+  values.scale(-1);
+  print(values.min());
+}
+bulk();
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|FloatArray[0, 0, 0, 0, 0]
+//|5
+//|5
+//|float_array
+//|5.5
+//|FloatArray[6.5, 6.5, 6.5, 6.5, 6.5]
+//|32.5
+//|-9
+//|11
+//|14.25
+//|[4, -1, 8.25, 1, 12, -8, 5]
+//|true
+//|false
+//|FloatArray[]
+//|500500
+//|0
+//|1000
+//|-1000
+// END EXPECTED OUTPUT
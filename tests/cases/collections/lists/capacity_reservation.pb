@@ -0,0 +1,44 @@
+var items = [];
+items.reserve(1000);
+print(len(items));
+for (var i = 0; i < 1000; i = i + 1) {
+  items.push(i);
+}
+print(items[999]);
+for (var i = 0; i < 990; i = i + 1) {
+  items.pop();
+}
+items.shrinkToFit();
+print(items);
+items.push(10);
+print(len(items));
+items.clear();
+items.shrinkToFit();
+print(items);
+
+var table = {"a": 1};
+table.reserve(500);
+for (var i = 0; i < 500; i = i + 1) {
+  table[i] = i;
+}
+print(len(table));
+for (var i = 0; i < 498; i = i + 1) {
+  table.delete(i);
+}
+table.shrinkToFit();
+print(table);
+table.reserve(0);
+table.clear();
+table.shrinkToFit();
+print(table);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|0
+//|999
+//|[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]
+//|11
+//|[]
+//|501
+//|{a: 1, 498: 498, 499: 499}
+//|{}
+// END EXPECTED OUTPUT
@@ -0,0 +1,51 @@
+var queue = [];
+for (var i = 0; i < 100000; i = i + 1) {
+  queue.push(i);
+}
+var total = 0;
+while (len(queue) > 0) {
+  total = total + queue.removeAt(0);
+}
+print(total == 4999950000);
+
+var rolling = [];
+for (var i = 0; i < 50000; i = i + 1) {
+  rolling.push(i);
+  if (len(rolling) > 3) rolling.pop(0);
+}
+print(rolling);
+
+var stack = [];
+for (var i = 0; i < 20000; i = i + 1) {
+  stack.insert(0, i);
+}
+print(stack[0] + stack[19999]);
+print(len(stack));
+
+var items = [1, 2, 3, 4, 5, 6];
+items.removeAt(1);
+items.insert(1, "b");
+items.pop(0);
+items.insert(0, "a");
+items.insert(-1, "e");
+items.remove(3);
+print(items);
+items.reserve(100);
+items.push(7);
+items.shrinkToFit();
+print(items);
+items.pop(0);
+items.pop(0);
+items.clear();
+items.insert(0, "only");
+print(items);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|true
+//|[49997, 49998, 49999]
+//|19999
+//|20000
+//|[a, b, 4, 5, e, 6]
+//|[a, b, 4, 5, e, 6, 7]
+//|[only]
+// END EXPECTED OUTPUT
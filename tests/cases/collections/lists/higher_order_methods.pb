@@ -0,0 +1,50 @@
+fun square(x) { return x * x; }
+fun isOdd(x) { return x % 2 == 1; }
+fun add(a, b) { return a + b; }
+fun append(text, value) { return text + str(value); }
+fun isBig(x) { return x > 4; }
+fun show(x) { print(x); }
+class Point {
+  init(x) { this.x = x; }
+  scaled(factor) { return this.x * factor; }
+}
+var values = [1, 2, 3, 4, 5];
+print(values.map(square));
+print(values.filter(isOdd));
+print(values.reduce(add));
+print(values.reduce(append, ">"));
+values.forEach(show);
+print(values.any(isBig));
+print(values.all(isBig));
+print([].any(isBig));
+print([].all(isBig));
+print(["a", "bb", "ccc"].map(len));
+var points = values.map(Point);
+print(points[4].x);
+print([10].map(Point(3).scaled));
+var queue = [1, 2, 3];
+fun grow(x) {
+  if (len(queue) < 6) queue.push(x + 3);
+  return x;
+}
+print(queue.map(grow));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|[1, 4, 9, 16, 25]
+//|[1, 3, 5]
+//|15
+//|>12345
+//|1
+//|2
+//|3
+//|4
+//|5
+//|true
+//|false
+//|false
+//|true
+//|[1, 2, 3]
+//|5
+//|[30]
+//|[1, 2, 3, 4, 5, 6]
+// END EXPECTED OUTPUT
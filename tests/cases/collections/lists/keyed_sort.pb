@@ -0,0 +1,73 @@
+class Entity {
+  init(name, health) {
+    this.name = name;
+    this.health = health;
+  }
+}
+
+fun health(entity) {
+  return entity.health;
+}
+
+fun name(entity) {
+  return entity.name;
+}
+
+fun names(entities) {
+  var result = [];
+  for (var i = 0; i < len(entities); i = i + 1) result.push(entities[i].name);
+  return result;
+}
+
+var party = [Entity("mira", 40), Entity("bo", 90), Entity("ash", 40), Entity("cy", 10)];
+party.sort(health);
+print(names(party));
+party.sort(health, true);
+print(names(party));
+party.sort(name);
+print(names(party));
+party.sort(name, true);
+print(names(party));
+
+var values = [3, 1, 2];
+values.sort(nil, true);
+print(values);
+var words = ["pear", "fig", "apple"];
+words.sort(len);
+print(words);
+
+var calls = 0;
+fun counted(value) {
+  calls = calls + 1;
+  return -value;
+}
+fun many() {
+  var values = [];
+  for (var i = 0; i < 1000; i = i + 1) values.push((i * 37) % 1000);
+  values.sort(counted);
+  print(values[0]);
+  print(values[999]);
+  print(calls);
+}
+many();
+
+// -0 is an equal key to 0 in either direction
+var zeros = [Entity("a", 0), Entity("b", -1 * 0), Entity("c", 0)];
+zeros.sort(health);
+print(names(zeros));
+zeros.sort(health, true);
+print(names(zeros));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|[cy, mira, ash, bo]
+//|[bo, mira, ash, cy]
+//|[ash, bo, cy, mira]
+//|[mira, cy, bo, ash]
+//|[3, 2, 1]
+//|[fig, pear, apple]
+//|999
+//|0
+//|1000
+//|[a, b, c]
+//|[a, b, c]
+// END EXPECTED OUTPUT
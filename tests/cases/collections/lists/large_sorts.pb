@@ -0,0 +1,81 @@
+fun sortedAscending(values) {
+  for (var i = 1; i < len(values); i = i + 1) {
+    if (values[i - 1] > values[i]) return false;
+  }
+  return true;
+}
+
+fun numbers() {
+  var values = [];
+  var seed = 99;
+  for (var i = 0; i < 3000; i = i + 1) {
+    seed = (seed * 7919 + 17) % 100003;
+    values.push((seed - 50000) / 8);
+  }
+  values.push(1000000000);
+  values.push(-1000000000);
+  values.push(0);
+  values.sort();
+  print(sortedAscending(values));
+  print(values[0]);
+  print(values[1]);
+  print(values[len(values) - 1]);
+}
+
+fun strings() {
+  var values = [];
+  var seed = 5;
+  for (var i = 0; i < 2000; i = i + 1) {
+    seed = (seed * 7919 + 17) % 100003;
+    values.push("item_" + str(seed % 500));
+  }
+  values.push("item_");
+  values.push("item_0000000000");
+  values.sort();
+  print(values[0]);
+  print(values[1]);
+  print(values[2]);
+  print(values[1000]);
+  print(values[len(values) - 1]);
+}
+
+numbers();
+strings();
+var mixed = ["b", "", "ab", "a", "abc", "b"];
+mixed.sort();
+print(mixed);
+
+// 0 and -0 are equal, so they keep their order on both sort paths
+var zero = 0;
+var negativeZero = -1 * 0;
+var zeros = [zero, negativeZero, zero];
+zeros.sort();
+print(zeros);
+zeros = [];
+for (var i = 0; i < 40; i = i + 1) {
+  if (i % 3 == 1) zeros.push(negativeZero); else zeros.push(zero);
+}
+zeros.push(-1);
+zeros.sort();
+print(zeros[0]);
+print(zeros[1]);
+print(zeros[2]);
+print(zeros[3]);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|true
+//|-1000000000
+//|-6240.625
+//|1000000000
+//|item_
+//|item_0
+//|item_0
+//|item_324
+//|item_99
+//|[, a, ab, abc, b, b]
+//|[0, -0, 0]
+//|-1
+//|0
+//|-0
+//|0
+// END EXPECTED OUTPUT
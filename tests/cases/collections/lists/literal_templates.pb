@@ -0,0 +1,49 @@
+fun fresh() {
+  return [1, -2, "three", true, nil];
+}
+let first = fresh();
+first.push(6);
+first[0] = 100;
+print(first);
+print(fresh());
+
+let x = 7;
+print([1, 2, x, 4, x * 2]);
+print([x, 1, 2]);
+print([[1, 2], [3, [4, 5]], []]);
+print(len([-500, -497, -494, -491, -488, -485, -482, -479, -476, -473, -470, -467, -464, -461, -458, -455, -452, -449, -446, -443, -440, -437, -434, -431, -428, -425, -422, -419, -416, -413, -410, -407, -404, -401, -398, -395, -392, -389, -386, -383, -380, -377, -374, -371, -368, -365, -362, -359, -356, -353, -350, -347, -344, -341, -338, -335, -332, -329, -326, -323, -320, -317, -314, -311, -308, -305, -302, -299, -296, -293, -290, -287, -284, -281, -278, -275, -272, -269, -266, -263, -260, -257, -254, -251, -248, -245, -242, -239, -236, -233, -230, -227, -224, -221, -218, -215, -212, -209, -206, -203, -200, -197, -194, -191, -188, -185, -182, -179, -176, -173, -170, -167, -164, -161, -158, -155, -152, -149, -146, -143, -140, -137, -134, -131, -128, -125, -122, -119, -116, -113, -110, -107, -104, -101, -98, -95, -92, -89, -86, -83, -80, -77, -74, -71, -68, -65, -62, -59, -56, -53, -50, -47, -44, -41, -38, -35, -32, -29, -26, -23, -20, -17, -14, -11, -8, -5, -2, 1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 49, 52, 55, 58, 61, 64, 67, 70, 73, 76, 79, 82, 85, 88, 91, 94, 97, 100, 103, 106, 109, 112, 115, 118, 121, 124, 127, 130, 133, 136, 139, 142, 145, 148, 151, 154, 157, 160, 163, 166, 169, 172, 175, 178, 181, 184, 187, 190, 193, 196, 199, 202, 205, 208, 211, 214, 217, 220, 223, 226, 229, 232, 235, 238, 241, 244, 247, 250, 253, 256, 259, 262, 265, 268, 271, 274, 277, 280, 283, 286, 289, 292, 295, 298, 301, 304, 307, 310, 313, 316, 319, 322, 325, 328, 331, 334, 337, 340, 343, 346, 349, 352, 355, 358, 361, 364, 367, 370, 373, 376, 379, 382, 385, 388, 391, 394, 397, 400, 403, 406, 409, 412, 415, 418, 421, 424, 427, 430, 433, 436, 439, 442, 445, 448, 451, 454, 457, 460, 463, 466, 469, 472, 475, 478, 481, 484, 487, 490, 493, 496, 499, 502, 505, 508, 511, 514, 517, 520, 523, 526, 529, 532, 535, 538, 541, 544, 547, 550, 553, 556, 559, 562, 565, 568, 571, 574, 577, 580, 583, 586, 589, 592, 595, 598, 601, 604, 607, 610, 613, 616, 619, 622, 625, 628, 631, 634, 637, 640, 643, 646, 649, 652, 655, 658, 661, 664, 667, 670, 673, 676, 679, 682, 685, 688, 691, 694, 697, 700, 703, 706, 709, 712, 715, 718, 721, 724, 727, 730, 733, 736, 739, 742, 745, 748, 751, 754, 757, 760, 763, 766, 769, 772, 775, 778, 781, 784, 787, 790, 793, 796, 799, 802, 805, 808, 811, 814, 817, 820, 823, 826, 829, 832, 835, 838, 841, 844, 847, 850, 853, 856, 859, 862, 865, 868, 871, 874, 877, 880, 883, 886, 889, 892, 895, 898, 901, 904, 907, 910, 913, 916, 919, 922, 925, 928, 931, 934, 937, 940, 943, 946, 949, 952, 955, 958, 961, 964, 967, 970, 973, 976, 979, 982, 985, 988, 991, 994, 997, 1000, 1003, 1006, 1009, 1012, 1015, 1018, 1021, 1024, 1027, 1030, 1033, 1036, 1039, 1042, 1045, 1048, 1051, 1054, 1057, 1060, 1063, 1066, 1069, 1072, 1075, 1078, 1081, 1084, 1087, 1090, 1093, 1096, 1099, 1102, 1105, 1108, 1111, 1114, 1117, 1120, 1123, 1126, 1129, 1132, 1135, 1138, 1141, 1144, 1147, 1150, 1153, 1156, 1159, 1162, 1165, 1168, 1171, 1174, 1177, 1180, 1183, 1186, 1189, 1192, 1195, 1198, 1201, 1204, 1207, 1210, 1213, 1216, 1219, 1222, 1225, 1228, 1231, 1234, 1237, 1240, 1243, 1246, 1249, 1252, 1255, 1258, 1261, 1264, 1267, 1270, 1273, 1276, 1279, 1282, 1285, 1288, 1291, 1294, 1297]));
+let table = [-500, -497, -494, -491, -488, -485, -482, -479, -476, -473, -470, -467, -464, -461, -458, -455, -452, -449, -446, -443, -440, -437, -434, -431, -428, -425, -422, -419, -416, -413, -410, -407, -404, -401, -398, -395, -392, -389, -386, -383, -380, -377, -374, -371, -368, -365, -362, -359, -356, -353, -350, -347, -344, -341, -338, -335, -332, -329, -326, -323, -320, -317, -314, -311, -308, -305, -302, -299, -296, -293, -290, -287, -284, -281, -278, -275, -272, -269, -266, -263, -260, -257, -254, -251, -248, -245, -242, -239, -236, -233, -230, -227, -224, -221, -218, -215, -212, -209, -206, -203, -200, -197, -194, -191, -188, -185, -182, -179, -176, -173, -170, -167, -164, -161, -158, -155, -152, -149, -146, -143, -140, -137, -134, -131, -128, -125, -122, -119, -116, -113, -110, -107, -104, -101, -98, -95, -92, -89, -86, -83, -80, -77, -74, -71, -68, -65, -62, -59, -56, -53, -50, -47, -44, -41, -38, -35, -32, -29, -26, -23, -20, -17, -14, -11, -8, -5, -2, 1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46, 49, 52, 55, 58, 61, 64, 67, 70, 73, 76, 79, 82, 85, 88, 91, 94, 97, 100, 103, 106, 109, 112, 115, 118, 121, 124, 127, 130, 133, 136, 139, 142, 145, 148, 151, 154, 157, 160, 163, 166, 169, 172, 175, 178, 181, 184, 187, 190, 193, 196, 199, 202, 205, 208, 211, 214, 217, 220, 223, 226, 229, 232, 235, 238, 241, 244, 247, 250, 253, 256, 259, 262, 265, 268, 271, 274, 277, 280, 283, 286, 289, 292, 295, 298, 301, 304, 307, 310, 313, 316, 319, 322, 325, 328, 331, 334, 337, 340, 343, 346, 349, 352, 355, 358, 361, 364, 367, 370, 373, 376, 379, 382, 385, 388, 391, 394, 397, 400, 403, 406, 409, 412, 415, 418, 421, 424, 427, 430, 433, 436, 439, 442, 445, 448, 451, 454, 457, 460, 463, 466, 469, 472, 475, 478, 481, 484, 487, 490, 493, 496, 499, 502, 505, 508, 511, 514, 517, 520, 523, 526, 529, 532, 535, 538, 541, 544, 547, 550, 553, 556, 559, 562, 565, 568, 571, 574, 577, 580, 583, 586, 589, 592, 595, 598, 601, 604, 607, 610, 613, 616, 619, 622, 625, 628, 631, 634, 637, 640, 643, 646, 649, 652, 655, 658, 661, 664, 667, 670, 673, 676, 679, 682, 685, 688, 691, 694, 697, 700, 703, 706, 709, 712, 715, 718, 721, 724, 727, 730, 733, 736, 739, 742, 745, 748, 751, 754, 757, 760, 763, 766, 769, 772, 775, 778, 781, 784, 787, 790, 793, 796, 799, 802, 805, 808, 811, 814, 817, 820, 823, 826, 829, 832, 835, 838, 841, 844, 847, 850, 853, 856, 859, 862, 865, 868, 871, 874, 877, 880, 883, 886, 889, 892, 895, 898, 901, 904, 907, 910, 913, 916, 919, 922, 925, 928, 931, 934, 937, 940, 943, 946, 949, 952, 955, 958, 961, 964, 967, 970, 973, 976, 979, 982, 985, 988, 991, 994, 997, 1000, 1003, 1006, 1009, 1012, 1015, 1018, 1021, 1024, 1027, 1030, 1033, 1036, 1039, 1042, 1045, 1048, 1051, 1054, 1057, 1060, 1063, 1066, 1069, 1072, 1075, 1078, 1081, 1084, 1087, 1090, 1093, 1096, 1099, 1102, 1105, 1108, 1111, 1114, 1117, 1120, 1123, 1126, 1129, 1132, 1135, 1138, 1141, 1144, 1147, 1150, 1153, 1156, 1159, 1162, 1165, 1168, 1171, 1174, 1177, 1180, 1183, 1186, 1189, 1192, 1195, 1198, 1201, 1204, 1207, 1210, 1213, 1216, 1219, 1222, 1225, 1228, 1231, 1234, 1237, 1240, 1243, 1246, 1249, 1252, 1255, 1258, 1261, 1264, 1267, 1270, 1273, 1276, 1279, 1282, 1285, 1288, 1291, 1294, 1297];
+print(table[0] + table[599]);
+fun batched(x) {
+  let computed = [x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x];
+  let wide = {"k0": x, "k1": x, "k2": x, "k3": x, "k4": x, "k5": x, "k6": x, "k7": x, "k8": x, "k9": x, "k10": x, "k11": x, "k12": x, "k13": x, "k14": x, "k15": x, "k16": x, "k17": x, "k18": x, "k19": x, "k20": x, "k21": x, "k22": x, "k23": x, "k24": x, "k25": x, "k26": x, "k27": x, "k28": x, "k29": x, "k30": x, "k31": x, "k32": x, "k33": x, "k34": x, "k35": x, "k36": x, "k37": x, "k38": x, "k39": x, "k40": x, "k41": x, "k42": x, "k43": x, "k44": x, "k45": x, "k46": x, "k47": x, "k48": x, "k49": x, "k50": x, "k51": x, "k52": x, "k53": x, "k54": x, "k55": x, "k56": x, "k57": x, "k58": x, "k59": x, "k60": x, "k61": x, "k62": x, "k63": x, "k64": x, "k65": x, "k66": x, "k67": x, "k68": x, "k69": x, "k70": x, "k71": x, "k72": x, "k73": x, "k74": x, "k75": x, "k76": x, "k77": x, "k78": x, "k79": x, "k80": x, "k81": x, "k82": x, "k83": x, "k84": x, "k85": x, "k86": x, "k87": x, "k88": x, "k89": x, "k90": x, "k91": x, "k92": x, "k93": x, "k94": x, "k95": x, "k96": x, "k97": x, "k98": x, "k99": x, "k100": x, "k101": x, "k102": x, "k103": x, "k104": x, "k105": x, "k106": x, "k107": x, "k108": x, "k109": x, "k110": x, "k111": x, "k112": x, "k113": x, "k114": x, "k115": x, "k116": x, "k117": x, "k118": x, "k119": x, "k120": x, "k121": x, "k122": x, "k123": x, "k124": x, "k125": x, "k126": x, "k127": x, "k128": x, "k129": x, "k130": x, "k131": x, "k132": x, "k133": x, "k134": x, "k135": x, "k136": x, "k137": x, "k138": x, "k139": x, "k140": x, "k141": x, "k142": x, "k143": x, "k144": x, "k145": x, "k146": x, "k147": x, "k148": x, "k149": x, "k150": x, "k151": x, "k152": x, "k153": x, "k154": x, "k155": x, "k156": x, "k157": x, "k158": x, "k159": x, "k160": x, "k161": x, "k162": x, "k163": x, "k164": x, "k165": x, "k166": x, "k167": x, "k168": x, "k169": x, "k170": x, "k171": x, "k172": x, "k173": x, "k174": x, "k175": x, "k176": x, "k177": x, "k178": x, "k179": x, "k180": x, "k181": x, "k182": x, "k183": x, "k184": x, "k185": x, "k186": x, "k187": x, "k188": x, "k189": x, "k190": x, "k191": x, "k192": x, "k193": x, "k194": x, "k195": x, "k196": x, "k197": x, "k198": x, "k199": x};
+  return len(computed) + computed[599] + len(wide) + wide["k199"];
+}
+print(batched(1));
+
+fun record() {
+  return {"name": "Mira", "hp": 100, "hp": 85, 1: -1};
+}
+let hero = record();
+hero["hp"] = 10;
+print(hero);
+print(record());
+print({"a": 1, "b": x, "c": 3});
+print({x: "key", "y": {"nested": true}});
+print({});
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|[100, -2, three, true, nil, 6]
+//|[1, -2, three, true, nil]
+//|[1, 2, 7, 4, 14]
+//|[7, 1, 2]
+//|[[1, 2], [3, [4, 5]], []]
+//|600
+//|797
+//|802
+//|{name: Mira, hp: 10, 1: -1}
+//|{name: Mira, hp: 85, 1: -1}
+//|{a: 1, b: 7, c: 3}
+//|{7: key, y: {nested: true}}
+//|{}
+// END EXPECTED OUTPUT
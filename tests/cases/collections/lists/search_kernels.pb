@@ -0,0 +1,47 @@
+class Box {}
+var box = Box();
+var other = Box();
+var values = [1, "one", nil, true, 0, box, [1, 2], false, -0, "one", nil, 1, [1, 2], other];
+print(values.index(0));
+print(values.count(0));
+print(values.count(-0));
+print(values.index("one"));
+print(values.count("one"));
+print(values.index(nil));
+print(values.count(nil));
+print(values.index(false));
+print(values.count(true));
+print(values.index(other));
+print(values.count(box));
+print(values.index([1, 2]));
+print(values.count([1, 2]));
+print(values.count(2));
+values.remove(1);
+values.remove("one");
+values.remove([1, 2]);
+print(values);
+var ranges = [range(3), range(0, 3), range(0, 3, 1)];
+print(ranges.index(range(0, 3)));
+print(ranges.count(range(3)));
+print(ranges.count(range(0, 4)));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|4
+//|2
+//|2
+//|1
+//|2
+//|2
+//|2
+//|7
+//|1
+//|13
+//|1
+//|6
+//|2
+//|0
+//|[nil, true, 0, Box instance, false, -0, one, nil, 1, [1, 2], Box instance]
+//|0
+//|3
+//|0
+// END EXPECTED OUTPUT
@@ -0,0 +1,30 @@
+var data = {};
+for (var i = 0; i < 40000; i = i + 1) {
+  data[i] = i * 2;
+}
+for (var i = 0; i < 40000; i = i + 1) {
+  if (i % 10000 != 7) data.delete(i);
+}
+print(data);
+print(data[20007]);
+print(data.has(20008));
+
+var churn = {"first": true};
+for (var i = 0; i < 5000; i = i + 1) {
+  churn["key" + str(i)] = i;
+  if (i > 0) churn.delete("key" + str(i - 1));
+}
+print(churn);
+print(len(churn));
+churn["first"] = false;
+churn["again"] = 1;
+print(churn);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|{7: 14, 10007: 20014, 20007: 40014, 30007: 60014}
+//|40014
+//|false
+//|{first: true, key4999: 4999}
+//|2
+//|{first: false, key4999: 4999, again: 1}
+// END EXPECTED OUTPUT
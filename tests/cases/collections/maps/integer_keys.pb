@@ -0,0 +1,48 @@
+var dense = {};
+for (var i = 0; i < 5; i = i + 1) {
+  dense[i] = i * i;
+}
+print(dense[3]);
+print(dense.has(5));
+print(dense.has("3"));
+print(dense[-0]);
+dense[1.5] = "half";
+print(dense[1.5]);
+print(dense);
+dense.delete(0);
+print(dense[4]);
+print(dense.has(0));
+
+var sparse = {};
+for (var i = 0; i < 2000; i = i + 1) {
+  sparse[i * 1024] = i;
+  sparse[-i] = -i;
+}
+print(sparse[1999 * 1024]);
+print(sparse[-1999]);
+print(sparse.has(1023));
+print(len(sparse));
+
+var mixed = {2147483648: "big", -2147483648: "small", 0.25: "quarter", "1": "string"};
+mixed[1] = "number";
+print(mixed[2147483648] + " " + mixed[-2147483648] + " " + mixed[0.25]);
+print(mixed[1] + " " + mixed["1"]);
+print(len(mixed));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|9
+//|false
+//|false
+//|0
+//|half
+//|{0: 0, 1: 1, 2: 4, 3: 9, 4: 16, 1.5: half}
+//|16
+//|false
+//|1999
+//|-1999
+//|false
+//|3999
+//|big small quarter
+//|number string
+//|5
+// END EXPECTED OUTPUT
@@ -0,0 +1,85 @@
+var numbers = PriorityQueue();
+numbers.push(5);
+numbers.push(-1);
+numbers.push(3);
+numbers.push(3);
+numbers.push(10);
+print(numbers.length);
+print(len(numbers));
+print(type(numbers));
+print(numbers);
+print(numbers.peek());
+var drained = [];
+while (numbers.length > 0) drained.push(numbers.pop());
+print(drained);
+
+// explicit priorities; equal ones leave in arrival order
+var tasks = PriorityQueue();
+tasks.push("render", 2);
+tasks.push("input", 1);
+tasks.push("audio", 2);
+tasks.push("physics", 1);
+print(tasks.pop() + " " + tasks.pop() + " " + tasks.pop() + " " + tasks.pop());
+
+var words = PriorityQueue();
+words.push("pear");
+words.push("apple");
+words.push("app");
+print(words.pop() + " " + words.pop() + " " + words.pop());
+words.push(4);
+print(words.pop());
+
+class Node {
+  init(name, cost) {
+    this.name = name;
+    this.cost = cost;
+  }
+}
+var calls = 0;
+fun byCost(node) {
+  calls = calls + 1;
+  return node.cost;
+}
+var frontier = PriorityQueue(byCost);
+frontier.push(Node("c", 7));
+frontier.push(Node("a", 1));
+frontier.push(Node("b", 4));
+print(frontier.pop().name + frontier.pop().name + frontier.pop().name);
+print(calls);
+
+fun heapSort() {
+  var queue = PriorityQueue();
+  var seed = 17;
+  for (var i = 0; i < 2000; i = i + 1) {
+    seed = (seed * 73 + 11) % 1009;
+    queue.push(seed);
+  }
+  var previous = -1;
+  var ordered = true;
+  var count = 0;
+  while (queue.length > 0) {
+    var next = queue.pop();
+    if (next < previous) ordered = false;
+    previous = next;
+    count = count + 1;
+  }
+  print(ordered);
+  print(count);
+}
+heapSort();
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|5
+//|5
+//|priority_queue
+//|<priority queue>
+//|-1
+//|[-1, 3, 3, 5, 10]
+//|input physics render audio
+//|app apple pear
+//|4
+//|abc
+//|3
+//|true
+//|2000
+// END EXPECTED OUTPUT
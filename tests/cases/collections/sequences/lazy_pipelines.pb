@@ -0,0 +1,49 @@
+fun square(x) { return x * x; }
+fun isEven(x) { return x % 2 == 0; }
+fun add(a, b) { return a + b; }
+fun label(x) { return "#" + str(x); }
+
+var numbers = range(1, 10, 3);
+print(numbers);
+print(len(numbers));
+print(numbers.length);
+print(type(numbers));
+print(numbers.toList());
+print(range(4).toList());
+print(range(3, -3, -2).toList());
+print(range(2, 2).toList());
+print(range(0, 3) == range(0, 3));
+
+var evens = range(10).map(square).filter(isEven);
+print(evens);
+print(type(evens));
+print(evens.toList());
+print(evens.reduce(add, 0));
+print(evens.map(label).toList());
+for (var value in evens) print(value);
+
+// nothing is materialized, so a long pipeline runs in constant memory
+print(range(200000).map(square).filter(isEven).reduce(add, 0) > 0);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|range(1, 10, 3)
+//|3
+//|3
+//|range
+//|[1, 4, 7]
+//|[0, 1, 2, 3]
+//|[3, 1, -1]
+//|[]
+//|true
+//|<sequence>
+//|sequence
+//|[0, 4, 16, 36, 64]
+//|120
+//|[#0, #4, #16, #36, #64]
+//|0
+//|4
+//|16
+//|36
+//|64
+//|true
+// END EXPECTED OUTPUT
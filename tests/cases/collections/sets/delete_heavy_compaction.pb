@@ -0,0 +1,22 @@
+fun churn() {
+  var ids = Set();
+  for (var i = 0; i < 5000; i = i + 1) ids.add(i);
+  for (var i = 0; i < 5000; i = i + 1) {
+    if (i % 1000 != 7) ids.delete(i);
+  }
+  print(ids);
+  for (var i = 0; i < 3; i = i + 1) ids.add("k" + str(i));
+  print(ids.values());
+  var total = 0;
+  for (var i = 0; i < 5000; i = i + 1) {
+    if (ids.has(i)) total = total + i;
+  }
+  print(total);
+}
+churn();
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|Set{7, 1007, 2007, 3007, 4007}
+//|[7, 1007, 2007, 3007, 4007, k0, k1, k2]
+//|10035
+// END EXPECTED OUTPUT
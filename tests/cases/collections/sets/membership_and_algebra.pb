@@ -0,0 +1,52 @@
+var seen = Set(["b", 1, nil, true, "b", 1]);
+print(seen);
+print(seen.length);
+print(len(seen));
+print(type(seen));
+print(seen.has("b"));
+print(seen.has("c"));
+print(seen.add("c"));
+print(seen.add("c"));
+print(seen.delete(nil));
+print(seen.delete(nil));
+print(seen);
+print(seen.values());
+
+var left = Set([1, 2, 3, 4]);
+var right = Set([3, 4, 5]);
+print(left.union(right));
+print(left.intersection(right));
+print(left.difference(right));
+print(right.difference(left));
+print(Set() == Set([]));
+print(Set([1, 2]) == Set([2, 1]));
+print(Set([1, 2]) == Set([1, 3]));
+print(str(Set(["x"])));
+seen.clear();
+print(seen);
+print(seen.has("b"));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|Set{b, 1, nil, true}
+//|4
+//|4
+//|set
+//|true
+//|false
+//|true
+//|false
+//|true
+//|false
+//|Set{b, 1, true, c}
+//|[b, 1, true, c]
+//|Set{1, 2, 3, 4, 5}
+//|Set{3, 4}
+//|Set{1, 2}
+//|Set{5}
+//|true
+//|true
+//|false
+//|Set{x}
+//|Set{}
+//|false
+// END EXPECTED OUTPUT
@@ -0,0 +1,44 @@
+print(chr(72) + chr(105));
+print(ord("A"));
+print(ord("Pogberry", 3));
+print(chr(ord("a") + 1));
+print(chr(65) == "A");
+print("xyz"[1] == chr(121));
+
+var view = "Hi!".bytes();
+print(view);
+print(len(view));
+print(view.length);
+print(view[0]);
+print(view[-1]);
+print(type(view));
+print(view == "Hi!".bytes());
+
+var sum = 0;
+for (let byte in "abc".bytes()) sum = sum + byte;
+print(sum);
+for (let i, byte in "ok".bytes()) print(str(i) + ":" + chr(byte));
+
+var shifted = StringBuilder();
+for (let c in "HAL") shifted.append(chr(ord(c) + 1));
+print(shifted.build());
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|Hi
+//|65
+//|98
+//|b
+//|true
+//|true
+//|Bytes[72, 105, 33]
+//|3
+//|3
+//|72
+//|33
+//|bytes
+//|true
+//|294
+//|0:o
+//|1:k
+//|IBM
+// END EXPECTED OUTPUT
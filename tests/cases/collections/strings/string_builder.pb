@@ -0,0 +1,34 @@
+var report = StringBuilder();
+print(report.len());
+print(report.build() == "");
+
+report.append("total: ").append(3).append(" of ").appendLine(4.5);
+report.append([1, "two", nil]).appendLine();
+report.appendLine(true);
+print(len(report));
+print(report.build());
+
+var built = report.build();
+print(built == report.build());
+print(type(report));
+print(report);
+
+report.clear();
+print(report.len());
+for (let i in range(5)) report.append(i);
+print(report.build());
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|0
+//|true
+//|35
+//|total: 3 of 4.5
+//|[1, two, nil]
+//|true
+//|
+//|true
+//|string_builder
+//|<string builder>
+//|0
+//|01234
+// END EXPECTED OUTPUT
@@ -0,0 +1,45 @@
+var line = "  name = Pogberry, version=2  ";
+print(line.trim());
+print(line.find("="));
+print(line.find("=", 9));
+print(line.find("zzz"));
+var parts = "a,b,,c".split(",");
+print(parts);
+print("-".join(parts));
+print("".join([]));
+print("aaaa".replace("aa", "b"));
+print("abc".replace("x", "y"));
+print("a.b.c".replace(".", "::"));
+print("Hello".startsWith("He"));
+print("Hello".endsWith("lo"));
+print("Hi".startsWith("Hello"));
+print("MiXeD 123".upper());
+print("MiXeD 123".lower());
+print("the quick brown fox jumps over the lazy dog, the end".find("the end"));
+print("x".split(","));
+print("abcabc".find("bc", 2));
+print("abc".find(""));
+print("abc".find("", 3));
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|name = Pogberry, version=2
+//|7
+//|26
+//|-1
+//|[a, b, , c]
+//|a-b--c
+//|
+//|bb
+//|abc
+//|a::b::c
+//|true
+//|true
+//|false
+//|MIXED 123
+//|mixed 123
+//|45
+//|[x]
+//|4
+//|0
+//|3
+// END EXPECTED OUTPUT
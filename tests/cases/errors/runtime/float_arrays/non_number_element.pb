@@ -0,0 +1,7 @@
+var buffer = FloatArray(4);
+buffer[2] = "loud";
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Float array elements must be numbers.
+//|[line 2] in script
+// END EXPECTED OUTPUT
@@ -0,0 +1,9 @@
+fun add(a, b) { return a + b; }
+var values = [1, 2];
+var total = values.reduce(add);
+values.map(add);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Expected 2 arguments but got 1.
+//|[line 4] in script
+// END EXPECTED OUTPUT
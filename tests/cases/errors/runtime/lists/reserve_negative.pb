@@ -0,0 +1,7 @@
+let items = [1, 2];
+items.reserve(-1);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|reserve() expects a non-negative integer.
+//|[line 2] in script
+// END EXPECTED OUTPUT
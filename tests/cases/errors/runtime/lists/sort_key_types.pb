@@ -0,0 +1,11 @@
+fun label(value) {
+  if (value > 1) return "big";
+  return value;
+}
+var values = [1, 2];
+values.sort(label);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|sort() requires keys of one supported type.
+//|[line 6] in script
+// END EXPECTED OUTPUT
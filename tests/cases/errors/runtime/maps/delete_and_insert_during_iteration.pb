@@ -0,0 +1,10 @@
+var seen = {"a": 1, "b": 2, "c": 3};
+for (var key in seen) {
+  seen.delete(key);
+  seen[key + "!"] = 0;
+}
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Map was modified during iteration.
+//|[line 2] in script
+// END EXPECTED OUTPUT
@@ -0,0 +1,9 @@
+var seen = {"a": 1};
+for (var key in seen) {
+  seen[key + "!"] = 2;
+}
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Map was modified during iteration.
+//|[line 2] in script
+// END EXPECTED OUTPUT
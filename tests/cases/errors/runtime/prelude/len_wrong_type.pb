@@ -1,6 +1,6 @@
 len(42);
 // EXPECTED STATUS: 70
 // EXPECTED OUTPUT:
-//|len() expects a string, list, or map.
+//|len() expects a string or a collection.
 //|[line 1] in script
 // END EXPECTED OUTPUT
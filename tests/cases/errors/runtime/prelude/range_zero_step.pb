@@ -0,0 +1,6 @@
+for (var i in range(0, 10, 0)) print(i);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|range() step must not be zero.
+//|[line 1] in script
+// END EXPECTED OUTPUT
@@ -0,0 +1,11 @@
+fun badKey(item) {
+  return item.cost;
+}
+var queue = PriorityQueue(badKey);
+queue.push(3);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Only instances have properties.
+//|[line 2] in badKey()
+//|[line 5] in script
+// END EXPECTED OUTPUT
@@ -0,0 +1,8 @@
+var queue = PriorityQueue();
+queue.push("a", 1);
+queue.push("b", "high");
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Priorities must be all numbers or all strings.
+//|[line 3] in script
+// END EXPECTED OUTPUT
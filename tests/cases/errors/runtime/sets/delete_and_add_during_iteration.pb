@@ -0,0 +1,12 @@
+var seen = Set();
+seen.add(1);
+seen.add(2);
+for (var value in seen) {
+  seen.delete(value);
+  seen.add(value + 10);
+}
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Set was modified during iteration.
+//|[line 4] in script
+// END EXPECTED OUTPUT
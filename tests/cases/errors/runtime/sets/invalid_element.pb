@@ -0,0 +1,7 @@
+var tags = Set();
+tags.add([]);
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|Set elements must be nil, booleans, finite numbers, or strings.
+//|[line 2] in script
+// END EXPECTED OUTPUT
@@ -0,0 +1,6 @@
+print(chr(256));
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|chr() expects a byte value from 0 to 255.
+//|[line 1] in script
+// END EXPECTED OUTPUT
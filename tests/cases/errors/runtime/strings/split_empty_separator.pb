@@ -0,0 +1,6 @@
+var fields = "a b c".split("");
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|split() cannot search for an empty string.
+//|[line 1] in script
+// END EXPECTED OUTPUT
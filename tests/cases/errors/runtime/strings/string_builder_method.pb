@@ -0,0 +1,7 @@
+var builder = StringBuilder();
+builder.push("x");
+// EXPECTED STATUS: 70
+// EXPECTED OUTPUT:
+//|String builders do not have a method named 'push'.
+//|[line 2] in script
+// END EXPECTED OUTPUT
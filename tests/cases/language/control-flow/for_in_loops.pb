@@ -0,0 +1,63 @@
+var total = 0;
+for (var value in [1, 2, 3]) total = total + value;
+print(total);
+for (var index, letter in ["a", "b"]) print(str(index) + letter);
+
+var ages = {"ada": 36, "alan": 41};
+for (var name in ages) print(name);
+for (var name, age in ages) print(name + " " + str(age));
+for (var name, age in ages) ages[name] = age + 1;
+print(ages);
+
+for (var char in "hey") print(char);
+for (var item in Set(["x", "y"])) print(item);
+for (var number in FloatArray([0.5, 1.5])) print(number);
+for (var value in []) print("never");
+
+var readers = [];
+for (var value in [1, 2, 3]) {
+  fun read() { return value; }
+  readers.push(read);
+}
+for (var read in readers) print(read());
+
+for (var value in [1, 2, 3, 4]) {
+  if (value == 3) break;
+  print(value);
+}
+
+var queue = [1];
+for (var value in queue) {
+  if (value < 4) queue.push(value + 1);
+}
+print(queue);
+
+var value = "outer";
+for (var value in [1]) print(value);
+print(value);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|6
+//|0a
+//|1b
+//|ada
+//|alan
+//|ada 36
+//|alan 41
+//|{ada: 37, alan: 42}
+//|h
+//|e
+//|y
+//|x
+//|y
+//|0.5
+//|1.5
+//|1
+//|2
+//|3
+//|1
+//|2
+//|[1, 2, 3, 4]
+//|1
+//|outer
+// END EXPECTED OUTPUT
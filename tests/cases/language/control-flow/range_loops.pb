@@ -0,0 +1,48 @@
+var total = 0;
+for (var i in range(5)) total = total + i;
+print(total);
+for (let i in range(6, 0, -2)) print(i);
+for (var i in range(3, 3)) print("never");
+
+var readers = [];
+for (var i in range(3)) {
+  fun read() { return i; }
+  readers.push(read);
+}
+for (var read in readers) print(read());
+
+for (var i in range(10)) {
+  if (i == 2) break;
+  print(i);
+}
+
+var numbers = range(2);
+for (var i in numbers) print(i);
+
+fun shadow() {
+  fun range(count) { return ["a", "b"]; }
+  for (var letter in range(2)) print(letter);
+}
+shadow();
+
+for (var x in range and [7, 8]) print(x);
+for (var x in range(1, 3) == nil or [9]) print(x);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|10
+//|6
+//|4
+//|2
+//|0
+//|1
+//|2
+//|0
+//|1
+//|0
+//|1
+//|a
+//|b
+//|7
+//|8
+//|9
+// END EXPECTED OUTPUT
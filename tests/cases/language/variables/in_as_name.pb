@@ -0,0 +1,17 @@
+var in = 3;
+fun next(in) { return in + 1; }
+print(next(in));
+
+let map = {"in": 1};
+print(map["in"]);
+
+for (var in in [4, 5]) print(in);
+for (var index, in in ["a"]) print(str(index) + in);
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|4
+//|1
+//|4
+//|5
+//|0a
+// END EXPECTED OUTPUT
@@ -0,0 +1,51 @@
+print(0.1 + 0.2);
+print(1 / 3);
+print(-0.5);
+print(100);
+print(-6240.625);
+print(4999950000);
+print(str(2.5) + "|" + str(-0));
+
+var big = 1;
+for (let i in range(21)) big = big * 10;
+print(big / 10);
+print(big);
+print(big * 1.5);
+
+print(0.000001);
+print(0.0000001);
+print(0.00000015);
+
+var huge = 1;
+for (let i in range(400)) huge = huge * 10;
+print(huge);
+print(-huge);
+print([0.1, 1000000, 0.000125]);
+print({"ratio": 0.75});
+print(FloatArray([1.25, 3]));
+
+var builder = StringBuilder();
+builder.append(0.1 * 3);
+print(builder.build());
+// EXPECTED STATUS: 0
+// EXPECTED OUTPUT:
+//|0.30000000000000004
+//|0.3333333333333333
+//|-0.5
+//|100
+//|-6240.625
+//|4999950000
+//|2.5|-0
+//|100000000000000000000
+//|1e+21
+//|1.5e+21
+//|0.000001
+//|1e-7
+//|1.5e-7
+//|inf
+//|-inf
+//|[0.1, 1000000, 0.000125]
+//|{ratio: 0.75}
+//|FloatArray[1.25, 3]
+//|0.30000000000000004
+// END EXPECTED OUTPUT
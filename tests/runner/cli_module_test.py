@@ -1,5 +1,6 @@
 from __future__ import annotations
 
+import json
 import subprocess
 import sys
 import tempfile
@@ -127,6 +128,50 @@ def main() -> int:
         require(result.returncode == 0, "help command failed")
         require("pb run [path]" in result.stdout, "help command output")
 
+        snapshots = []
+        for count in (10, 25):
+            write(
+                root / "leak.pb",
+                "class Session { init() { this.events = []; } }\n"
+                "var sessions = [];\n"
+                f"for (var i = 0; i < {count}; i = i + 1) sessions.push(Session());\n",
+            )
+            snapshot = root / f"heap-{count}.json"
+            result = command(
+                binary, ["run", "--heap-snapshot", snapshot, root / "leak.pb"]
+            )
+            require(result.returncode == 0, "heap snapshot run failed")
+            lines = snapshot.read_text(encoding="utf-8").splitlines()
+            require(lines[0].startswith('{"snapshot":1,'), "heap snapshot header")
+            records = [json.loads(line) for line in lines[1:]]
+            root_record = records[0]
+            require(
+                root_record["type"] == "root"
+                and root_record["retained"] == sum(r["size"] for r in records),
+                "heap snapshot retained sizes",
+            )
+            sessions = [
+                r
+                for r in records
+                if r["type"] == "instance" and r.get("label") == "Session"
+            ]
+            require(len(sessions) == count, "heap snapshot instances")
+            require(
+                all(r["retained"] > r["size"] for r in sessions),
+                "instances retain their event lists",
+            )
+            snapshots.append(snapshot)
+
+        result = command(binary, ["heap-diff", *snapshots])
+        require(result.returncode == 0, "heap diff failed")
+        require(
+            any(
+                line.split()[:4] == ["instance", "Session", "25", "+15"]
+                for line in result.stdout.splitlines()
+            ),
+            "heap diff groups instances by class",
+        )
+
         write(project / "missing.pb", 'use "unknown" as unknown;\n')
         result = run(binary, project / "missing.pb")
         require(result.returncode == 70, "missing module status")
@@ -113,6 +113,99 @@ static bool resolveCapability(PbVM *instance, const char *name,
       sizeof(definitions) / sizeof(definitions[0]));
 }
 
+#define TRACKING_HEADER sizeof(max_align_t)
+
+typedef struct
+{
+  size_t liveBytes;
+  size_t allocations;
+  bool sizeMismatch;
+} TrackingAllocator;
+
+static void *trackingReallocate(void *pointer, size_t oldSize,
+                                size_t newSize, void *userData)
+{
+  TrackingAllocator *tracker = (TrackingAllocator *)userData;
+  unsigned char *block =
+      pointer == NULL ? NULL : (unsigned char *)pointer - TRACKING_HEADER;
+  if (block != NULL && *(size_t *)block != oldSize)
+    tracker->sizeMismatch = true;
+  tracker->liveBytes -= oldSize;
+  if (newSize == 0)
+  {
+    free(block);
+    return NULL;
+  }
+  block = (unsigned char *)realloc(block, newSize + TRACKING_HEADER);
+  if (block == NULL)
+    return NULL;
+  if (pointer == NULL)
+    tracker->allocations++;
+  *(size_t *)block = newSize;
+  tracker->liveBytes += newSize;
+  return block + TRACKING_HEADER;
+}
+
+typedef struct
+{
+  unsigned char *base;
+  size_t used;
+  size_t capacity;
+  int releases;
+} Arena;
+
+static void *arenaReallocate(void *pointer, size_t oldSize,
+                             size_t newSize, void *userData)
+{
+  Arena *arena = (Arena *)userData;
+  if (newSize == 0)
+    return NULL;
+  if (newSize <= oldSize)
+    return pointer;
+  size_t start = (arena->used + TRACKING_HEADER - 1) &
+                 ~(TRACKING_HEADER - 1);
+  if (start + newSize > arena->capacity)
+    return NULL;
+  arena->used = start + newSize;
+  if (pointer != NULL)
+    memcpy(arena->base + start, pointer, oldSize);
+  return arena->base + start;
+}
+
+static void arenaRelease(void *userData)
+{
+  Arena *arena = (Arena *)userData;
+  arena->used = 0;
+  arena->releases++;
+}
+
+typedef struct
+{
+  char *text;
+  size_t length;
+  size_t capacity;
+} Snapshot;
+
+static void captureSnapshot(PbVM *instance, const char *text,
+                            size_t length, void *userData)
+{
+  (void)instance;
+  Snapshot *snapshot = (Snapshot *)userData;
+  if (snapshot->length + length + 1 > snapshot->capacity)
+  {
+    size_t capacity = snapshot->capacity < 4096 ? 4096 : snapshot->capacity;
+    while (snapshot->length + length + 1 > capacity)
+      capacity *= 2;
+    snapshot->text = (char *)realloc(snapshot->text, capacity);
+    if (snapshot->text == NULL)
+      exit(1);
+    snapshot->capacity = capacity;
+  }
+  memcpy(snapshot->text + snapshot->length, text, length);
+  snapshot->length += length;
+  snapshot->text[snapshot->length] = '\0';
+}
+
 static void require(bool condition, const char *message)
 {
   if (!condition)
@@ -134,9 +227,9 @@ int main(void)
   Capture first = {0};
   Capture second = {0};
   PbConfig firstConfig = {
-      captureOutput, captureDiagnostic, resolveCapability, &first};
+      captureOutput, captureDiagnostic, resolveCapability, &first, {0}, {0}};
   PbConfig secondConfig = {
-      captureOutput, captureDiagnostic, resolveCapability, &second};
+      captureOutput, captureDiagnostic, resolveCapability, &second, {0}, {0}};
 
   PbVM *firstVM = pbCreateVM(&firstConfig);
   PbVM *secondVM = pbCreateVM(&secondConfig);
@@ -384,6 +477,221 @@ int main(void)
           "VM remains usable after errors");
   requireNumber(result, 20, "post-error return value");
 
+  Capture paced = {0};
+  PbConfig pacedConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &paced,
+      {64 * 1024, 3.0, 0, 0.000001}, {0}};
+  PbVM *pacedVM = pbCreateVM(&pacedConfig);
+  require(pacedVM != NULL, "paced VM creation");
+  PbGCStats stats;
+  require(pbGetGCStats(pacedVM, &stats), "initial GC stats");
+  require(stats.collections == 0 && stats.nextCollection == 64 * 1024,
+          "configured first collection threshold");
+  require(pbInterpret(pacedVM,
+                      "let keep = [];\n"
+                      "for (var i = 0; i < 20000; i = i + 1) {\n"
+                      "  let garbage = [i, str(i)];\n"
+                      "  if (i % 100 == 0) keep.push(garbage);\n"
+                      "}\n"
+                      "print(len(keep));\n") == INTERPRET_OK,
+          "paced VM allocation workload");
+  require(strcmp(paced.output, "200\n") == 0, "paced VM output");
+  require(pbGetGCStats(pacedVM, &stats), "GC stats after workload");
+  require(stats.collections > 0, "collections counted");
+  size_t histogramTotal = 0;
+  for (int i = 0; i < PB_GC_PAUSE_BUCKETS; i++)
+    histogramTotal += stats.pauseHistogram[i];
+  require(histogramTotal == stats.collections, "pause histogram total");
+  require(stats.totalBytesFreed > 0, "freed bytes counted");
+  require(stats.nextCollection >= 64 * 1024, "minimum heap floor");
+  require(stats.heapGrowthFactor >= 1.0 && stats.heapGrowthFactor < 3.0,
+          "growth factor shrinks while pauses exceed the target");
+  require(stats.liveObjects[PB_OBJECT_LIST] >= 201,
+          "live list objects counted");
+  size_t collections = stats.collections;
+  pbCollectGarbage(pacedVM);
+  require(pbGetGCStats(pacedVM, &stats) &&
+              stats.collections == collections + 1,
+          "explicit collection");
+  require(stats.liveBytes == stats.bytesAllocated, "live bytes after collection");
+  require(stats.lastBytesMarked > 0 &&
+              stats.lastBytesMarked <= stats.liveBytes,
+          "marked bytes counted");
+  require(stats.internTombstones == 0, "interning table compacted");
+  pbDestroyVM(pacedVM);
+
+  Capture interned = {0};
+  PbConfig internedConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &interned, {0}, {0}};
+  PbVM *internedVM = pbCreateVM(&internedConfig);
+  require(internedVM != NULL, "interning VM creation");
+  require(pbInterpret(internedVM,
+                      "var words = [];\n"
+                      "for (var i = 0; i < 20000; i = i + 1) {\n"
+                      "  words.push(\"word \" + str(i));\n"
+                      "}\n"
+                      "print(len(words));\n") == INTERPRET_OK,
+          "interning workload");
+  pbCollectGarbage(internedVM);
+  require(pbGetGCStats(internedVM, &stats) && stats.internedStrings > 20000,
+          "interned strings counted");
+  size_t busiestCapacity = stats.internCapacity;
+  require(stats.internMaxProbe >= 1 && stats.internAverageProbe >= 1.0 &&
+              stats.internAverageProbe < 2.0,
+          "interning probe lengths");
+  require(pbInterpret(internedVM, "words = nil;\n") == INTERPRET_OK,
+          "drop interned strings");
+  pbCollectGarbage(internedVM);
+  require(pbGetGCStats(internedVM, &stats) &&
+              stats.internCapacity <= busiestCapacity / 4 &&
+              stats.internTombstones == 0,
+          "interning table shrinks after collection");
+  pbDestroyVM(internedVM);
+
+  Capture capped = {0};
+  PbConfig cappedConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &capped,
+      {256 * 1024, 2.0, 1024 * 1024, 0}, {0}};
+  PbVM *cappedVM = pbCreateVM(&cappedConfig);
+  require(cappedVM != NULL, "capped VM creation");
+  require(pbInterpret(cappedVM,
+                      "fun grow() {\n"
+                      "  var items = [];\n"
+                      "  for (var i = 0; i < 200000; i = i + 1) {\n"
+                      "    items.push([i]);\n"
+                      "  }\n"
+                      "  return len(items);\n"
+                      "}\n"
+                      "fun small() { return [1, 2, 3]; }\n"
+                      "print(grow());\n") == INTERPRET_RUNTIME_ERROR,
+          "heap limit raises a runtime error");
+  require(strstr(capped.diagnostics,
+                 "Out of memory: heap limit of 1048576 bytes exceeded.") != NULL,
+          "heap limit diagnostic");
+  require(strstr(capped.diagnostics, "in grow()") != NULL,
+          "heap limit stack trace");
+  require(strcmp(capped.output, "") == 0, "heap limit stops the script");
+  require(pbCall(cappedVM, "small", 0, NULL, &result) == INTERPRET_OK,
+          "VM remains usable after running out of memory");
+  pbCollectGarbage(cappedVM);
+  require(pbGetGCStats(cappedVM, &stats) &&
+              stats.bytesAllocated <= 1024 * 1024,
+          "heap released after out-of-memory unwinding");
+  require(pbInterpret(cappedVM, "print(len(small()));") == INTERPRET_OK,
+          "interpret after running out of memory");
+  require(strcmp(capped.output, "3\n") == 0, "post-limit output");
+  require(pbInterpret(cappedVM,
+                      "var text = \"x\";\n"
+                      "while (true) text = text + text;\n") ==
+              INTERPRET_RUNTIME_ERROR,
+          "oversized request raises a runtime error");
+  require(pbGetGCStats(cappedVM, &stats) &&
+              stats.bytesAllocated <= 1024 * 1024,
+          "oversized request is refused before it is allocated");
+  pbDestroyVM(cappedVM);
+
+  Capture tracked = {0};
+  TrackingAllocator tracker = {0};
+  PbConfig trackedConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &tracked,
+      {0}, {trackingReallocate, NULL, &tracker}};
+  PbVM *trackedVM = pbCreateVM(&trackedConfig);
+  require(trackedVM != NULL, "tracked VM creation");
+  require(pbInterpret(trackedVM,
+                      "use \"host.math\";\n"
+                      "let words = {\"a\\tb\": [1, 2], \"c\": \"d\\n\"};\n"
+                      "print(math.hostEcho(str(words)));\n"
+                      "fun loop() { while (true) { break; } return 1; }\n"
+                      "print(loop());\n") == INTERPRET_OK,
+          "tracked VM interpretation");
+  require(pbInterpret(trackedVM, "print(;") == INTERPRET_COMPILE_ERROR,
+          "tracked VM compile error");
+  require(pbInterpret(trackedVM, "math.hostAdd(1);") ==
+              INTERPRET_RUNTIME_ERROR,
+          "tracked VM runtime error");
+  require(tracker.allocations > 0 && tracker.liveBytes > 0,
+          "VM memory goes through the host allocator");
+  pbDestroyVM(trackedVM);
+  require(!tracker.sizeMismatch, "allocator sees consistent sizes");
+  require(tracker.liveBytes == 0, "VM returns every tracked byte");
+
+  Capture snapshotCapture = {0};
+  PbConfig snapshotConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &snapshotCapture,
+      {0}, {0}};
+  PbVM *snapshotVM = pbCreateVM(&snapshotConfig);
+  require(snapshotVM != NULL, "snapshot VM creation");
+  require(pbInterpret(snapshotVM,
+                      "let holder = [\"snapshot \\\"marker\\\"\", [1, 2, 3]];\n"
+                      "let temporary = [[], []];\n"
+                      "temporary = nil;\n"
+                      "class Holder { get() { return holder; } }\n"
+                      "let bound = Holder().get;\n") == INTERPRET_OK,
+          "snapshot VM interpretation");
+  Snapshot snapshot = {0};
+  require(pbWriteHeapSnapshot(snapshotVM, captureSnapshot, &snapshot),
+          "heap snapshot written");
+  require(strncmp(snapshot.text, "{\"snapshot\":1,", 14) == 0,
+          "heap snapshot header");
+  require(strstr(snapshot.text, "{\"id\":0,\"type\":\"root\"") != NULL,
+          "heap snapshot root record");
+  require(strstr(snapshot.text,
+                 "\"label\":\"snapshot \\\"marker\\\"\"") != NULL,
+          "heap snapshot escapes labels");
+  int lists = 0;
+  for (const char *cursor = snapshot.text;
+       (cursor = strstr(cursor, "\"type\":\"list\"")) != NULL; cursor++)
+    lists++;
+  require(lists == 2, "heap snapshot only holds reachable objects");
+  require(strstr(snapshot.text, "\"type\":\"bound_method\"") != NULL,
+          "heap snapshot type names use underscores");
+  free(snapshot.text);
+  pbDestroyVM(snapshotVM);
+
+  Capture arenaCapture = {0};
+  Arena arena = {0};
+  arena.capacity = 32 * 1024 * 1024;
+  arena.base = (unsigned char *)malloc(arena.capacity);
+  require(arena.base != NULL, "arena backing allocation");
+  PbConfig arenaConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &arenaCapture,
+      {0}, {arenaReallocate, arenaRelease, &arena}};
+  for (int round = 0; round < 3; round++)
+  {
+    PbVM *arenaVM = pbCreateVM(&arenaConfig);
+    require(arenaVM != NULL, "arena VM creation");
+    require(pbInterpret(arenaVM,
+                        "var total = 0;\n"
+                        "for (var i = 0; i < 1000; i = i + 1) total = total + len(str(i));\n"
+                        "print(total);\n") == INTERPRET_OK,
+            "arena VM interpretation");
+    require(arena.used > 0, "arena VM allocates from the arena");
+    pbDestroyVM(arenaVM);
+    require(arena.used == 0 && arena.releases == round + 1,
+            "arena VM destruction resets the arena");
+  }
+  require(strcmp(arenaCapture.output, "2890\n2890\n2890\n") == 0,
+          "arena VM output");
+
+  Capture exhaustedCapture = {0};
+  arena.capacity = 2 * 1024 * 1024;
+  PbConfig exhaustedConfig = {
+      captureOutput, captureDiagnostic, resolveCapability, &exhaustedCapture,
+      {0}, {arenaReallocate, arenaRelease, &arena}};
+  PbVM *exhaustedVM = pbCreateVM(&exhaustedConfig);
+  require(exhaustedVM != NULL, "exhausted arena VM creation");
+  require(pbInterpret(exhaustedVM, "var text = \"x\";\nwhile (true) text = text + text;\n") ==
+              INTERPRET_RUNTIME_ERROR,
+          "allocator failure raises a runtime error");
+  require(strstr(exhaustedCapture.diagnostics,
+                 "Out of memory: the allocator could not provide") != NULL,
+          "allocator failure diagnostic");
+  require(pbInterpret(exhaustedVM, "print(len(text));\n") == INTERPRET_OK &&
+              exhaustedCapture.output[0] != '\0',
+          "VM remains usable after the allocator fails");
+  pbDestroyVM(exhaustedVM);
+  free(arena.base);
+
   pbDestroyVM(firstVM);
   pbDestroyVM(secondVM);
   puts("host API test passed");